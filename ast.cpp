@@ -2,6 +2,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
 
 #include "ast.h"
 #include "common.h"
@@ -100,7 +104,8 @@ void Visitor::nodeVisit(IfStatementNode *ifStatementNode) {
 }
 
 void Visitor::nodeVisit(WhileStatementNode *whileStatementNode) {
-
+    whileStatementNode->getConditionExpression()->visit(*this);
+    whileStatementNode->getBodyStatement()->visit(*this);
 }
 
 void Visitor::nodeVisit(AssignmentNode *assignmentNode) {
@@ -363,6 +368,17 @@ class Printer: public Visitor {
             fprintf(m_out, ")");
         }
 
+        virtual void nodeVisit(WhileStatementNode *whileStatementNode) {
+            // (WHILE cond body-stmt)
+            fprintf(m_out, "(WHILE");
+            printSourceLocation(whileStatementNode);
+            fprintf(m_out, " ");
+            whileStatementNode->getConditionExpression()->visit(*this);
+            fprintf(m_out, " ");
+            whileStatementNode->getBodyStatement()->visit(*this);
+            fprintf(m_out, ")");
+        }
+
         virtual void nodeVisit(AssignmentNode *assignmentNode) {
             // (ASSIGN type variable-name new-value)
             fprintf(m_out, "(ASSIGN");
@@ -451,6 +467,102 @@ std::string getSourceLocationString(const SourceLocation &srcLoc) {
             std::to_string(srcLoc.lastColumn));
 }
 
+/* Names are stored in a deque so that references returned by getSymbolName stay valid */
+static std::deque<std::string> &getSymbolNames() {
+    // constructed on first use, symbols may be interned during static initialization
+    static std::deque<std::string> symbolNames;
+    return symbolNames;
+}
+
+SymbolID internSymbol(const std::string &name) {
+    static std::unordered_map<std::string, SymbolID> symbolIDs;
+    auto result = symbolIDs.emplace(name, static_cast<SymbolID>(getSymbolNames().size()));
+    if(result.second) {
+        getSymbolNames().push_back(name);
+    }
+    return result.first->second;
+}
+
+const std::string &getSymbolName(SymbolID symbol) {
+    return getSymbolNames().at(symbol);
+}
+
+class NodeArena {
+    private:
+        static constexpr size_t BlockSize = 64 * 1024;
+        static constexpr size_t Alignment = alignof(std::max_align_t);
+    private:
+        std::vector<char *> m_blocks;
+        char *m_next = nullptr;
+        size_t m_remaining = 0;
+        std::unordered_map<size_t, void *> m_freeLists;    // freed memory by size, linked through its first word
+    private:
+        static size_t getAlignedSize(size_t size) { return (size + Alignment - 1) & ~(Alignment - 1); }
+    public:
+        ~NodeArena() { release(); }
+    public:
+        void *allocate(size_t size) {
+            size = getAlignedSize(size);
+            auto freeList = m_freeLists.find(size);
+            if(freeList != m_freeLists.end() && freeList->second != nullptr) {
+                void *ptr = freeList->second;
+                freeList->second = *static_cast<void **>(ptr);
+                return ptr;
+            }
+            if(size > m_remaining) {
+                size_t blockSize = std::max(size, BlockSize);
+                m_blocks.push_back(static_cast<char *>(::operator new(blockSize)));
+                m_next = m_blocks.back();
+                m_remaining = blockSize;
+            }
+            void *ptr = m_next;
+            m_next += size;
+            m_remaining -= size;
+            return ptr;
+        }
+        void deallocate(void *ptr, size_t size) {
+            size = getAlignedSize(size);
+            if(ptr == nullptr || size == 0) {
+                return;
+            }
+            if(static_cast<char *>(ptr) + size == m_next) {
+                // the latest allocation goes back to the current block
+                m_next -= size;
+                m_remaining += size;
+                return;
+            }
+            void *&freeList = m_freeLists[size];
+            *static_cast<void **>(ptr) = freeList;
+            freeList = ptr;
+        }
+        void release() {
+            for(char *block: m_blocks) {
+                ::operator delete(block);
+            }
+            m_blocks.clear();
+            m_freeLists.clear();
+            m_next = nullptr;
+            m_remaining = 0;
+        }
+};
+
+static NodeArena &getNodeArena() {
+    static NodeArena nodeArena;
+    return nodeArena;
+}
+
+void *allocateNodeMemory(size_t size) {
+    return getNodeArena().allocate(size);
+}
+
+void deallocateNodeMemory(void *ptr, size_t size) {
+    getNodeArena().deallocate(ptr, size);
+}
+
+void releaseNodeMemory() {
+    getNodeArena().release();
+}
+
 } /* END NAMESPACE */
 
 //////////////////////////////////////////////////////////////////
@@ -561,7 +673,7 @@ node *ast_allocate(node_kind kind, ...) {
         }
 
         case ID_NODE: {
-            const char *id = va_arg(args, char *);
+            AST::SymbolID id = va_arg(args, AST::SymbolID);
             astNode = new AST::IdentifierNode(id);
 
             YYLTYPE *loc = va_arg(args, YYLTYPE *);
@@ -576,7 +688,7 @@ node *ast_allocate(node_kind kind, ...) {
              * Use expression as index.
              * Need another layer to convert IntLiteralNode to ExpressionNode.
              */
-            const char *id = va_arg(args, char *);
+            AST::SymbolID id = va_arg(args, AST::SymbolID);
             AST::ExpressionNode *indexExpr = static_cast<AST::ExpressionNode *>(va_arg(args, AST::ASTNode *));
             
             AST::IdentifierNode *idNode = new AST::IdentifierNode(id);
@@ -593,7 +705,7 @@ node *ast_allocate(node_kind kind, ...) {
         }
 
         case FUNCTION_NODE: {
-            const char *functionName = va_arg(args, char *);
+            AST::SymbolID functionName = va_arg(args, AST::SymbolID);
             AST::ExpressionsNode *argExprs = static_cast<AST::ExpressionsNode *>(va_arg(args, AST::ASTNode *));
             astNode = new AST::FunctionNode(functionName, argExprs);
 
@@ -692,7 +804,7 @@ node *ast_allocate(node_kind kind, ...) {
         }
 
         case DECLARATION_NODE: {
-            const char *varName = va_arg(args, char *);
+            AST::SymbolID varName = va_arg(args, AST::SymbolID);
             int isConst = va_arg(args, int);
             int type = va_arg(args, int);
             AST::ExpressionNode *initValExpr = static_cast<AST::ExpressionNode *>(va_arg(args, AST::ASTNode *));
@@ -732,10 +844,13 @@ node *ast_allocate(node_kind kind, ...) {
     return static_cast<node *>(astNode);
 }
 
+/*
+ * Nodes own no memory outside of the arena, so ast_free releases the whole arena, i.e. every
+ * node allocated since the last ast_free and not only the tree of ast. No node of an earlier
+ * tree may be used afterwards.
+ */
 void ast_free(node *ast) {
-    if(ast != nullptr) {
-        AST::ASTNode::destructNode(static_cast<AST::ASTNode *>(ast));
-    }
+    AST::releaseNodeMemory();
 }
 
 void ast_print(node *ast) {
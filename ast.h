@@ -2,6 +2,8 @@
 #define AST_H_ 1
 
 #include <stdarg.h>
+#include <stdint.h>
+#include <stddef.h>
 
 #include <string>
 #include <vector>
@@ -163,6 +165,39 @@ std::string getTypeString(int type);
 std::string getOperatorString(int op);
 std::string getSourceLocationString(const SourceLocation &srcLoc);
 
+/* Identifiers are interned by the scanner, then compared and hashed by SymbolID */
+using SymbolID = uint32_t;
+SymbolID internSymbol(const std::string &name);
+const std::string &getSymbolName(SymbolID symbol);
+
+/*
+ * All AST nodes and node lists of a compilation are bump-allocated from one arena. Memory of
+ * destructed nodes and regrown lists is reused by later allocations of the same size, and
+ * ast_free releases the whole arena at once without destructing the nodes one by one
+ */
+void *allocateNodeMemory(size_t size);
+void deallocateNodeMemory(void *ptr, size_t size);
+void releaseNodeMemory();
+
+template<typename T>
+class NodeAllocator {
+    public:
+        using value_type = T;
+    public:
+        NodeAllocator() = default;
+        template<typename U> NodeAllocator(const NodeAllocator<U> &) {}
+    public:
+        T *allocate(size_t n) { return static_cast<T *>(allocateNodeMemory(n * sizeof(T))); }
+        void deallocate(T *ptr, size_t n) { deallocateNodeMemory(ptr, n * sizeof(T)); }
+    public:
+        template<typename U> bool operator==(const NodeAllocator<U> &) const { return true; }
+        template<typename U> bool operator!=(const NodeAllocator<U> &) const { return false; }
+};
+
+using ExpressionList = std::vector<ExpressionNode *, NodeAllocator<ExpressionNode *>>;
+using StatementList = std::vector<StatementNode *, NodeAllocator<StatementNode *>>;
+using DeclarationList = std::list<DeclarationNode *, NodeAllocator<DeclarationNode *>>;
+
 #define AST_VISIT_THIS_NODE     public:                                             \
                                 virtual void visit(Visitor &visitor) {              \
                                     visitor.visit(this);                            \
@@ -182,6 +217,9 @@ class ASTNode {
         std::string getSourceLocationString() const { return AST::getSourceLocationString(m_srcLoc); }
     protected:
         virtual ~ASTNode() {}
+    public:
+        static void *operator new(size_t size) { return allocateNodeMemory(size); }
+        static void operator delete(void *ptr, size_t size) { deallocateNodeMemory(ptr, size); }
     public:
         /* The only way to destruct any AST ASTNode */
         static void destructNode(ASTNode *astNode) { delete astNode; }
@@ -197,18 +235,25 @@ class ExpressionNode: public ASTNode {
     public:
         std::string getExpressionTypeString() const { return getTypeString(getExpressionType()); }
         std::string getExpressionQualifierString() const { return isConst() ? "const " : ""; }
+    public:
+        /* Synthesized by TypeChecker, nullptr if no write-only variable is read in this expression */
+        const VariableNode *getFirstWriteOnlyVariable() const { return m_firstWriteOnlyVar; }
+        void setFirstWriteOnlyVariable(const VariableNode *var) { m_firstWriteOnlyVar = var; }
+    private:
+        const VariableNode *m_firstWriteOnlyVar = nullptr;
     protected:
         virtual ~ExpressionNode() {}
 };
 
 class ExpressionsNode: public ASTNode {
     private:
-        std::vector<ExpressionNode *> m_expressions;    // A list of ExpressionNodes
+        ExpressionList m_expressions;                   // A list of ExpressionNodes
     public:
         void pushBackExpression(ExpressionNode *expr) { m_expressions.push_back(expr); }
-        const std::vector<ExpressionNode *> &getExpressionList() const { return m_expressions; }
+        const ExpressionList &getExpressionList() const { return m_expressions; }
         unsigned getNumberExpression() const { return m_expressions.size(); }
         ExpressionNode *getExpressionAt(unsigned idx) const { return m_expressions.at(idx); }
+        void setExpressionAt(unsigned idx, ExpressionNode *expr) { m_expressions.at(idx) = expr; }
     protected:
         virtual ~ExpressionsNode() {
             for(ExpressionNode *expr: m_expressions) {
@@ -236,6 +281,7 @@ class UnaryExpressionNode: public ExpressionNode {
     public:
         int getOperator() const { return m_op; }
         ExpressionNode *getExpression() const { return m_expr; }
+        void setExpression(ExpressionNode *expr) { m_expr = expr; }
     protected:
         virtual ~UnaryExpressionNode() {
             ASTNode::destructNode(m_expr);
@@ -263,6 +309,8 @@ class BinaryExpressionNode: public ExpressionNode {
         int getOperator() const { return m_op; }
         ExpressionNode *getLeftExpression() const { return m_leftExpr; }
         ExpressionNode *getRightExpression() const { return m_rightExpr; }
+        void setLeftExpression(ExpressionNode *leftExpr) { m_leftExpr = leftExpr; }
+        void setRightExpression(ExpressionNode *rightExpr) { m_rightExpr = rightExpr; }
     protected:
         virtual ~BinaryExpressionNode() {
             ASTNode::destructNode(m_leftExpr);
@@ -326,7 +374,7 @@ class BooleanLiteralNode: public ExpressionNode {
 class DeclarationNode: public ASTNode {
     private:
         // not using IdentifierNode because the name itself is not yet an expression
-        std::string m_variableName;                     // variable name
+        SymbolID m_variableName;                        // variable name
         bool m_isConst;                                 // const qualified
         bool m_isReadOnly = false;                      // read-only qualified
         bool m_isWriteOnly = false;                     // write-only qualified
@@ -334,16 +382,18 @@ class DeclarationNode: public ASTNode {
         ExpressionNode *m_initValExpr = nullptr;        // initial value expression (optional)
         ExpressionNode *m_initVal = nullptr;            // value of initial value expression (optional)
     public:
-        DeclarationNode(const std::string &variableName, bool isConst, int type, ExpressionNode *initValExpr = nullptr):
+        DeclarationNode(SymbolID variableName, bool isConst, int type, ExpressionNode *initValExpr = nullptr):
             m_variableName(variableName), m_isConst(isConst), m_type(type), m_initValExpr(initValExpr) {}
     public:
-        const std::string &getName() const { return m_variableName; }
+        const std::string &getName() const { return getSymbolName(m_variableName); }
+        SymbolID getSymbolID() const { return m_variableName; }
         bool isConst() const { return m_isConst; }
         bool isReadOnly() const { return m_isReadOnly; }
         bool isWriteOnly() const { return m_isWriteOnly; }
         int getType() const { return m_type; }
         std::string getTypeString() const { return AST::getTypeString(m_type); }
         ExpressionNode *getExpression() const { return m_initValExpr; }
+        void setExpression(ExpressionNode *initValExpr) { m_initValExpr = initValExpr; }
         ExpressionNode *getInitValue() const { return m_initVal; }
         void setInitValue(ExpressionNode *initVal) { m_initVal = initVal; }
     public:
@@ -395,10 +445,10 @@ class VariableNode: public ExpressionNode {
 class IdentifierNode: public VariableNode {
     private:
         int m_type = ANY_TYPE;                          // types defined in parser.tab.h
-        std::string m_id;                               // name of this identifier
+        SymbolID m_id;                                  // name of this identifier
         const DeclarationNode *m_decl = nullptr;        // declaration of this IdentifierNode
     public:
-        IdentifierNode(const std::string &id):
+        IdentifierNode(SymbolID id):
             m_id(id) {}
     public:
         virtual int getExpressionType() const { return m_type; }
@@ -412,7 +462,8 @@ class IdentifierNode: public VariableNode {
         virtual bool isResultType() const { return m_decl ? m_decl->isResultType() : false; }
         virtual bool isOrdinaryType() const { return m_decl ? m_decl->isOrdinaryType() : true; }
     public:
-        virtual std::string getName() const { return m_id; }
+        virtual std::string getName() const { return getSymbolName(m_id); }
+        SymbolID getSymbolID() const { return m_id; }
         virtual const DeclarationNode *getDeclaration() const { return m_decl; }
     public:
         void setDeclaration(const DeclarationNode *decl) { m_decl = decl; }
@@ -461,17 +512,18 @@ class IndexingNode: public VariableNode {
 class FunctionNode: public ExpressionNode {
     private:
         int m_type = ANY_TYPE;                          // types defined in parser.tab.h
-        std::string m_functionName;                     // name of this function
+        SymbolID m_functionName;                        // name of this function
         ExpressionsNode *m_argExprs;                    // argument expressions of this function
     public:
-        FunctionNode(const std::string &functionName, ExpressionsNode *argExprs):
+        FunctionNode(SymbolID functionName, ExpressionsNode *argExprs):
             m_functionName(functionName), m_argExprs(argExprs) {}
     public:
         virtual int getExpressionType() const { return m_type; }
         virtual void setExpressionType(int type) { m_type = type; }
         virtual bool isConst() const { return false; }
     public:
-        const std::string &getName() const { return m_functionName; }
+        const std::string &getName() const { return getSymbolName(m_functionName); }
+        SymbolID getSymbolID() const { return m_functionName; }
         ExpressionsNode *getArgumentExpressions() const { return m_argExprs; }
     protected:
         virtual ~FunctionNode() {
@@ -514,10 +566,10 @@ class StatementNode: public ASTNode {
 
 class StatementsNode: public ASTNode {
     private:
-        std::vector<StatementNode *> m_statements;      // a list of StatementNodes
+        StatementList m_statements;                     // a list of StatementNodes
     public:
         void pushBackStatement(StatementNode *stmt) { m_statements.push_back(stmt); }
-        const std::vector<StatementNode *> &getStatementList() const { return m_statements; }
+        const StatementList &getStatementList() const { return m_statements; }
     protected:
         virtual ~StatementsNode() {
             for(StatementNode *stmt: m_statements) {
@@ -530,11 +582,11 @@ class StatementsNode: public ASTNode {
 
 class DeclarationsNode: public ASTNode {
     private:
-        std::list<DeclarationNode *> m_declarations;    // a list of DeclarationNodes
+        DeclarationList m_declarations;                 // a list of DeclarationNodes
     public:
         void pushBackDeclaration(DeclarationNode *decl) { m_declarations.push_back(decl); }
         void pushFrontDeclaration(DeclarationNode *decl) { m_declarations.push_front(decl); }
-        const std::list<DeclarationNode *> &getDeclarationList() const { return m_declarations; }
+        const DeclarationList &getDeclarationList() const { return m_declarations; }
     protected:
         virtual ~DeclarationsNode() {
             for(DeclarationNode *decl: m_declarations) {
@@ -555,6 +607,7 @@ class IfStatementNode: public StatementNode {
             m_condExpr(condExpr), m_thenStmt(thenStmt), m_elseStmt(elseStmt) {}
     public:
         ExpressionNode *getConditionExpression() const { return m_condExpr; }
+        void setConditionExpression(ExpressionNode *condExpr) { m_condExpr = condExpr; }
         StatementNode *getThenStatement() const { return m_thenStmt; }
         StatementNode *getElseStatement() const { return m_elseStmt; }
     protected:
@@ -570,13 +623,17 @@ class IfStatementNode: public StatementNode {
 };
 
 class WhileStatementNode: public StatementNode {
-    /* No Support */
+    /* Unrolled by codegen, the trip count must be bounded at compile time */
     private:
         ExpressionNode *m_condExpr;                     // condition expression
         StatementNode *m_bodyStmt;                      // loop body statement
     public:
         WhileStatementNode(ExpressionNode *condExpr, StatementNode *bodyStmt):
             m_condExpr(condExpr), m_bodyStmt(bodyStmt) {}
+    public:
+        ExpressionNode *getConditionExpression() const { return m_condExpr; }
+        void setConditionExpression(ExpressionNode *condExpr) { m_condExpr = condExpr; }
+        StatementNode *getBodyStatement() const { return m_bodyStmt; }
     protected:
         virtual ~WhileStatementNode() {
             ASTNode::destructNode(m_condExpr);
@@ -600,6 +657,7 @@ class AssignmentNode: public StatementNode {
         std::string getExpressionTypeString() const { return getTypeString(m_type); }
         VariableNode *getVariable() const { return m_var; }
         ExpressionNode *getExpression() const { return m_newValExpr; }
+        void setExpression(ExpressionNode *newValExpr) { m_newValExpr = newValExpr; }
     protected:
         virtual ~AssignmentNode() {
             ASTNode::destructNode(m_var);
@@ -713,6 +771,7 @@ typedef enum {
 } node_kind;
 
 node *ast_allocate(node_kind type, ...);
+/* Releases every node allocated since the last call, not only those of ast */
 void ast_free(node *ast);
 void ast_print(node * ast);
 
@@ -1,17 +1,22 @@
 #include "codegen.h"
 
 #include "ast.h"
+#include "ir.h"
 #include "semantic.h"
 #include "common.h"
 #include "parser.tab.h"
 
 #include <cassert>
+#include <algorithm>
+#include <cmath>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <string>
 #include <sstream>
 #include <iomanip>
 #include <memory>
+#include <array>
 
 
 /*
@@ -36,6 +41,19 @@ static const std::unordered_map<std::string, std::string> l_predefinedVariableRe
     {"env3", "program.env[3]"}
 };
 
+static const AST::SymbolID l_rsqFunctionName = AST::internSymbol("rsq");
+static const AST::SymbolID l_dp3FunctionName = AST::internSymbol("dp3");
+static const AST::SymbolID l_litFunctionName = AST::internSymbol("lit");
+
+static const std::unordered_set<std::string> l_uniformVariableNames = {
+    "gl_Light_Half",
+    "gl_Light_Ambient",
+    "gl_Material_Shininess",
+    "env1",
+    "env2",
+    "env3"
+};
+
 std::string getPredefinedVariableRegisterName(const std::string &variableName) {
     auto fit = l_predefinedVariableRegisterName.find(variableName);
     if(fit == l_predefinedVariableRegisterName.end()) {
@@ -59,6 +77,64 @@ std::string getRegisterIndexing(unsigned index) {
 }
 
 
+/* Shortest decimal that reads back as the same float, always with a decimal point */
+std::string getFloatString(float value) {
+    char buffer[32];
+    for(int precision = 6; precision <= 9; precision++) {
+        snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+        if(strtof(buffer, nullptr) == value) {
+            break;
+        }
+    }
+    std::string floatString = buffer;
+    if(floatString.find_first_of(".en") == std::string::npos) {
+        floatString += ".0";
+    }
+    return floatString;
+}
+
+
+/* Operands are in the form of [-]regName[.swizzle] */
+std::string getOperandRegisterName(const std::string &operand) {
+    size_t nameBegin = (!operand.empty() && operand[0] == '-') ? 1 : 0;
+    size_t nameEnd = operand.find('.', nameBegin);
+    if(nameEnd == std::string::npos) {
+        return operand.substr(nameBegin);
+    }
+    return operand.substr(nameBegin, nameEnd - nameBegin);
+}
+
+bool isOperandMasked(const std::string &operand) {
+    size_t nameBegin = (!operand.empty() && operand[0] == '-') ? 1 : 0;
+    return operand.find('.', nameBegin) != std::string::npos;
+}
+
+/* Components of the register read (or written) by each component of the operand */
+std::array<unsigned, 4> getOperandComponents(const std::string &operand) {
+    static const std::string componentNames = "xyzw";
+    size_t nameBegin = (!operand.empty() && operand[0] == '-') ? 1 : 0;
+    size_t suffixBegin = operand.find('.', nameBegin);
+    std::string suffix = (suffixBegin == std::string::npos) ? "xyzw" : operand.substr(suffixBegin + 1);
+
+    std::array<unsigned, 4> components;
+    for(unsigned i = 0; i < 4; i++) {
+        components[i] = componentNames.find(suffix[std::min<size_t>(i, suffix.size() - 1)]);
+        assert(components[i] < 4);
+    }
+    return components;
+}
+
+std::string renameOperandRegister(const std::string &operand, const std::string &regName) {
+    size_t nameBegin = (!operand.empty() && operand[0] == '-') ? 1 : 0;
+    size_t nameEnd = operand.find('.', nameBegin);
+    std::string renamed = operand.substr(0, nameBegin) + regName;
+    if(nameEnd != std::string::npos) {
+        renamed += operand.substr(nameEnd);
+    }
+    return renamed;
+}
+
+
 #define OP_FIELDWIDTH 7
 #define REG_FIELDWIDTH 24
 #define VALUE_FIELDWIDTH 36
@@ -122,6 +198,10 @@ class ARBAssemblyDatabase {
         // MAX v,v v maximum
         // MIN v,v v minimum
         // ABS v v absolute value
+        // MAD v,v,v v multiply and add
+        // LRP v,v,v v linear interpolation
+        // SGE v,v v set on greater than or equal
+        // DP4 v,v ssss 4-component dot product
         enum class OPCode {
             CMP,
             MOV,
@@ -135,7 +215,11 @@ class ARBAssemblyDatabase {
             RSQ,
             MAX,
             MIN,
-            ABS
+            ABS,
+            MAD,
+            LRP,
+            SGE,
+            DP4
         };
 
     private:
@@ -182,6 +266,19 @@ class ARBAssemblyDatabase {
             
                 virtual ~ARBInstruction() = default;
 
+            public:
+                OPCode getOPCode() const { return m_OPCode; }
+                std::string &getOutput() { return m_out; }
+                std::vector<std::string *> getInputs() {
+                    std::vector<std::string *> inputs;
+                    for(std::string *in: {&m_in0, &m_in1, &m_in2}) {
+                        if(!in->empty()) {
+                            inputs.push_back(in);
+                        }
+                    }
+                    return inputs;
+                }
+
             public:
                 virtual std::string generateCode() const {
                     std::stringstream ss;
@@ -309,6 +406,50 @@ class ARBAssemblyDatabase {
                             ss << std::left << ";";
                             return ss.str();
                         }
+                        case OPCode::MAD: {
+                            ss << std::left << std::setw(OP_FIELDWIDTH) << "MAD";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_out;
+                            ss << std::left << std::setw(SYMBOL_FIELDWIDTH) << ",";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_in0;
+                            ss << std::left << std::setw(SYMBOL_FIELDWIDTH) << ",";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_in1;
+                            ss << std::left << std::setw(SYMBOL_FIELDWIDTH) << ",";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_in2;
+                            ss << std::left << ";";
+                            return ss.str();
+                        }
+                        case OPCode::LRP: {
+                            ss << std::left << std::setw(OP_FIELDWIDTH) << "LRP";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_out;
+                            ss << std::left << std::setw(SYMBOL_FIELDWIDTH) << ",";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_in0;
+                            ss << std::left << std::setw(SYMBOL_FIELDWIDTH) << ",";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_in1;
+                            ss << std::left << std::setw(SYMBOL_FIELDWIDTH) << ",";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_in2;
+                            ss << std::left << ";";
+                            return ss.str();
+                        }
+                        case OPCode::SGE: {
+                            ss << std::left << std::setw(OP_FIELDWIDTH) << "SGE";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_out;
+                            ss << std::left << std::setw(SYMBOL_FIELDWIDTH) << ",";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_in0;
+                            ss << std::left << std::setw(SYMBOL_FIELDWIDTH) << ",";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_in1;
+                            ss << std::left << ";";
+                            return ss.str();
+                        }
+                        case OPCode::DP4: {
+                            ss << std::left << std::setw(OP_FIELDWIDTH) << "DP4";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_out;
+                            ss << std::left << std::setw(SYMBOL_FIELDWIDTH) << ",";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_in0;
+                            ss << std::left << std::setw(SYMBOL_FIELDWIDTH) << ",";
+                            ss << std::left << std::setw(REG_FIELDWIDTH) << m_in1;
+                            ss << std::left << ";";
+                            return ss.str();
+                        }
                         default:
                             assert(0);
                             return "";
@@ -316,68 +457,122 @@ class ARBAssemblyDatabase {
                 }
         };
 
+        class ConstantPoolEntry {
+            private:
+                std::string m_regName;
+                std::array<float, 4> m_values;
+                unsigned m_numberComponents;
+
+            public:
+                ConstantPoolEntry(const std::string &regName, const std::array<float, 4> &values, unsigned numberComponents):
+                    m_regName(regName), m_values(values), m_numberComponents(numberComponents) {}
+
+            public:
+                const std::string &getRegName() const { return m_regName; }
+
+                /* Finds or appends each value, fails if the free components are not enough */
+                bool place(const std::vector<float> &values, std::array<unsigned, 4> &components) {
+                    std::array<float, 4> placedValues = m_values;
+                    unsigned numberComponents = m_numberComponents;
+                    for(unsigned i = 0; i < values.size(); i++) {
+                        // prefer the same component, so that vectors read without swizzle
+                        if(i < numberComponents && placedValues[i] == values[i]) {
+                            components[i] = i;
+                            continue;
+                        }
+
+                        auto begin = placedValues.begin();
+                        auto fit = std::find(begin, begin + numberComponents, values[i]);
+                        if(fit == begin + numberComponents) {
+                            if(numberComponents == 4) {
+                                return false;
+                            }
+                            placedValues[numberComponents++] = values[i];
+                        }
+                        components[i] = std::find(begin, begin + numberComponents, values[i]) - begin;
+                        assert(components[i] < numberComponents);
+                    }
+
+                    m_values = placedValues;
+                    m_numberComponents = numberComponents;
+                    return true;
+                }
+
+                ParamRegDeclaration getDeclaration() const {
+                    if(m_numberComponents == 1) {
+                        return ParamRegDeclaration(m_regName, getFloatString(m_values[0]));
+                    }
+
+                    std::string regValue = "{";
+                    for(unsigned i = 0; i < m_numberComponents; i++) {
+                        regValue += (i == 0 ? "" : ",") + getFloatString(m_values[i]);
+                    }
+                    regValue += "}";
+                    return ParamRegDeclaration(m_regName, regValue);
+                }
+        };
+
     private:
         /* For user-defined variables */
         std::vector<TempRegDeclaration> m_userTempRegDeclarations;
-        std::vector<ParamRegDeclaration> m_userParamRegDeclarations;
 
         /* For auto-generated intermediate variables */
         std::vector<TempRegDeclaration> m_autoTempRegDeclarations;
-        unsigned m_autoTempRegDeclarationsSessionCount = 0;
-        /* For auto-generated long-live intermediate variables */
-        std::vector<TempRegDeclaration> m_autoLongLiveTempRegDeclarations;
-        /* For auto-generated immediate values */
-        std::vector<ParamRegDeclaration> m_autoParamRegDeclarations = {
-            {"__$param_true", "{1.0,1.0,1.0,1.0}"},
-            {"__$param_false", "{-1.0,-1.0,-1.0,-1.0}"},
-            {"__$param_zero", "{0.0,0.0,0.0,0.0}"}
+        /* For auto-generated immediate values, packed into the components of shared PARAMs */
+        std::vector<ConstantPoolEntry> m_constantPool = {
+            {"__$param_true", {{1.0, 1.0, 1.0, 1.0}}, 4},
+            {"__$param_false", {{-1.0, -1.0, -1.0, -1.0}}, 4},
+            {"__$param_zero", {{0.0, 0.0, 0.0, 0.0}}, 4}
         };
-        static constexpr unsigned m_autoParamRegDeclarationsInitSize = 3;
+        unsigned m_autoParamRegCount = 0;
 
         /* For assembly instructions */
         std::vector<std::unique_ptr<Instruction>> m_instructions;
 
+        /* For physical registers, all TEMPs above are virtual once allocated */
+        std::vector<TempRegDeclaration> m_allocatedTempRegDeclarations;
+        std::vector<std::vector<std::string>> m_allocatedTempRegContents;
+        bool m_tempRegistersAllocated = false;
+
+        /* OPTION ARB_precision_hint_fastest, trading precision for speed */
+        bool m_precisionHintFastest = false;
+
+    public:
+        void setPrecisionHintFastest(bool precisionHintFastest) { m_precisionHintFastest = precisionHintFastest; }
+
     public:
         void declareUserTempRegister(const std::string &regName) {
             m_userTempRegDeclarations.emplace_back(regName);
         }
 
-        void declareUserParamRegister(const std::string &regName, const std::string &regValue) {
-            m_userParamRegDeclarations.emplace_back(regName, regValue);
-        }
-
     public:
-        void newAutoTempRegisterAllocationSession() { m_autoTempRegDeclarationsSessionCount = 0; }
-
         const std::string &requestAutoTempRegister() {
-            if(m_autoTempRegDeclarationsSessionCount < m_autoTempRegDeclarations.size()) {
-                return m_autoTempRegDeclarations[m_autoTempRegDeclarationsSessionCount++].getRegName();
-            }
-            assert(m_autoTempRegDeclarationsSessionCount == m_autoTempRegDeclarations.size());
-            m_autoTempRegDeclarations.emplace_back("__$temp_" + std::to_string(m_autoTempRegDeclarationsSessionCount++));
-            assert(m_autoTempRegDeclarationsSessionCount == m_autoTempRegDeclarations.size());
+            unsigned count = m_autoTempRegDeclarations.size();
+            m_autoTempRegDeclarations.emplace_back("__$temp_" + std::to_string(count));
 
             return m_autoTempRegDeclarations.back().getRegName();
         }
 
-        const std::string &requestLongLiveAutoTempRegister() {
-            unsigned count = m_autoLongLiveTempRegDeclarations.size();
-            m_autoLongLiveTempRegDeclarations.emplace_back("__$templl_" + std::to_string(count));
-
-            return m_autoLongLiveTempRegDeclarations.back().getRegName();
-        }
+        /* PARAM holding the values, and the component holding each of them */
+        const std::string &requestAutoParamRegister(const std::vector<float> &values, std::array<unsigned, 4> &components) {
+            assert(values.size() >= 1 && values.size() <= 4);
+            // NaN never compares equal, and neither NaN nor infinity can be written in a PARAM
+            assert(std::all_of(values.begin(), values.end(), [](float value) { return std::isfinite(value); }));
+            for(ConstantPoolEntry &entry: m_constantPool) {
+                if(entry.place(values, components)) {
+                    return entry.getRegName();
+                }
+            }
 
-        const std::string &requestAutoParamRegister(const std::string &regValue) {
-            unsigned count = m_autoParamRegDeclarations.size() - m_autoParamRegDeclarationsInitSize;
-            m_autoParamRegDeclarations.emplace_back("__$param_" + std::to_string(count), regValue);
+            unsigned count = m_autoParamRegCount++;
+            m_constantPool.emplace_back("__$param_" + std::to_string(count), std::array<float, 4>{{0.0, 0.0, 0.0, 0.0}}, 0);
+            bool isPlaced = m_constantPool.back().place(values, components);
+            assert(isPlaced);
+            (void)isPlaced;
 
-            return m_autoParamRegDeclarations.back().getRegName();
+            return m_constantPool.back().getRegName();
         }
 
-        const std::string &getAutoTrueParamRegister() const { return m_autoParamRegDeclarations.at(0).getRegName(); }
-        const std::string &getAutoFalseParamRegister() const { return m_autoParamRegDeclarations.at(1).getRegName(); }
-        const std::string &getAutoZeroParamRegister() const { return m_autoParamRegDeclarations.at(2).getRegName(); }
-
     public:
         void insertInstruction(OPCode opCode, const std::string &out, const std::string &in0, std::string in1 = "", std::string in2 = "") {
             m_instructions.emplace_back(new ARBInstruction(opCode, out, in0, in1, in2));
@@ -386,47 +581,48 @@ class ARBAssemblyDatabase {
         void insertInstructionComment(const std::string &comment) {
             m_instructions.emplace_back(new ARBComment(comment));
         }
+
+    public:
+        void allocateTempRegisters();
+        void removeUnusedDeclarations();
     
     public:
         std::vector<std::string> generateCode() const {
             std::vector<std::string> assemblyCode;
 
 
-            assemblyCode.emplace_back("# User Declared Non-Constant Variables");
-            for(const auto &tempDecl: m_userTempRegDeclarations) {
-                assemblyCode.push_back(tempDecl.generateCode());
-            }
-            assemblyCode.emplace_back("");
-
-
-            assemblyCode.emplace_back("");
-            assemblyCode.emplace_back("# User Declared Constant Variables");
-            for(const auto &paramDecl: m_userParamRegDeclarations) {
-                assemblyCode.push_back(paramDecl.generateCode());
-            }
-            assemblyCode.emplace_back("");
+            if(m_tempRegistersAllocated) {
+                assemblyCode.emplace_back("# Allocated Temporary Registers");
+                for(unsigned i = 0; i < m_allocatedTempRegDeclarations.size(); i++) {
+                    std::string contents;
+                    for(const auto &regName: m_allocatedTempRegContents[i]) {
+                        contents += (contents.empty() ? "" : ", ") + regName;
+                    }
+                    assemblyCode.push_back("# " + m_allocatedTempRegDeclarations[i].getRegName() + " : " + contents);
+                    assemblyCode.push_back(m_allocatedTempRegDeclarations[i].generateCode());
+                }
+                assemblyCode.emplace_back("");
+            } else {
+                assemblyCode.emplace_back("# User Declared Non-Constant Variables");
+                for(const auto &tempDecl: m_userTempRegDeclarations) {
+                    assemblyCode.push_back(tempDecl.generateCode());
+                }
+                assemblyCode.emplace_back("");
 
 
-            assemblyCode.emplace_back("");
-            assemblyCode.emplace_back("# Auto-Generated Re-usable Intermediate Value Registers");
-            for(const auto &tempDecl: m_autoTempRegDeclarations) {
-                assemblyCode.push_back(tempDecl.generateCode());
+                assemblyCode.emplace_back("");
+                assemblyCode.emplace_back("# Auto-Generated Intermediate Value Registers");
+                for(const auto &tempDecl: m_autoTempRegDeclarations) {
+                    assemblyCode.push_back(tempDecl.generateCode());
+                }
+                assemblyCode.emplace_back("");
             }
-            assemblyCode.emplace_back("");
-
-
-            assemblyCode.emplace_back("");
-            assemblyCode.emplace_back("# Auto-Generated Non-reusable Intermediate Value Registers");
-            for(const auto &tempDecl: m_autoLongLiveTempRegDeclarations) {
-                assemblyCode.push_back(tempDecl.generateCode());
-            }
-            assemblyCode.emplace_back("");
 
 
             assemblyCode.emplace_back("");
             assemblyCode.emplace_back("# Auto-Generated Immediate Value Registers");
-            for(const auto &paramDecl: m_autoParamRegDeclarations) {
-                assemblyCode.push_back(paramDecl.generateCode());
+            for(const auto &poolEntry: m_constantPool) {
+                assemblyCode.push_back(poolEntry.getDeclaration().generateCode());
             }
             assemblyCode.emplace_back("");
 
@@ -450,35 +646,205 @@ class ARBAssemblyDatabase {
             }
         }
 
-        void output(FILE *fd) const {
+        /* The complete fragment program, as written by output */
+        std::string generateProgram() const {
             std::vector<std::string> assemblyCode = generateCode();
-            
-            fprintf(fd, "!!ARBfp1.0\n");
-            fprintf(fd, "\n");
+            std::string program;
+
+            program += "!!ARBfp1.0\n";
+            if(m_precisionHintFastest) {
+                program += "OPTION ARB_precision_hint_fastest;\n";
+            }
+            program += "\n";
 
             for(const auto &line: assemblyCode) {
-                fprintf(fd, "%s\n", line.c_str());
+                program += line + "\n";
             }
 
-            fprintf(fd, "\n");
-            fprintf(fd, "END\n");
+            program += "\n";
+            program += "END\n";
+            return program;
+        }
+
+        void output(FILE *fd) const {
+            std::string program = generateProgram();
+            fwrite(program.data(), 1, program.size(), fd);
         }
 };
 
+/*
+    Linear scan register allocation over the instruction stream.
+    Fragment programs are straight-line code, so a live range of a virtual TEMP begins
+    at a full write (or at a read of an undefined value) and ends at the last access before
+    the next full write. Masked writes keep the other components, hence extend the live range.
+    Every live range is assigned to the lowest physical TEMP that is free when it begins.
+    Inputs are read before the output is written, so a live range ending at an instruction
+    can share the physical TEMP with the one beginning at the same instruction.
+*/
+void ARBAssemblyDatabase::allocateTempRegisters() {
+    struct TempLiveRange {
+        std::string virtualRegName;
+        unsigned begin;
+        unsigned end;
+        unsigned physicalRegIndex;
+    };
+
+    std::unordered_set<std::string> virtualRegNames;
+    for(const auto *tempDecls: {&m_userTempRegDeclarations, &m_autoTempRegDeclarations}) {
+        for(const auto &tempDecl: *tempDecls) {
+            virtualRegNames.insert(tempDecl.getRegName());
+        }
+    }
+
+    std::vector<TempLiveRange> liveRanges;
+    std::unordered_map<std::string, unsigned> currentLiveRanges;
+    std::vector<std::pair<std::string *, unsigned>> operandLiveRanges;
+
+    auto beginLiveRange = [&](const std::string &regName, unsigned position) -> unsigned {
+        liveRanges.push_back({regName, position, position, 0});
+        currentLiveRanges[regName] = liveRanges.size() - 1;
+        return liveRanges.size() - 1;
+    };
+
+    unsigned position = 0;
+    for(auto &ins: m_instructions) {
+        ARBInstruction *arbIns = dynamic_cast<ARBInstruction *>(ins.get());
+        if(arbIns == nullptr) {
+            continue;
+        }
+
+        for(std::string *in: arbIns->getInputs()) {
+            std::string regName = getOperandRegisterName(*in);
+            if(virtualRegNames.count(regName) == 0) {
+                continue;
+            }
+
+            auto fit = currentLiveRanges.find(regName);
+            if(fit == currentLiveRanges.end()) {
+                operandLiveRanges.emplace_back(in, beginLiveRange(regName, position));
+            } else {
+                liveRanges[fit->second].end = position;
+                operandLiveRanges.emplace_back(in, fit->second);
+            }
+        }
+
+        std::string &out = arbIns->getOutput();
+        std::string regName = getOperandRegisterName(out);
+        if(virtualRegNames.count(regName) == 1) {
+            auto fit = currentLiveRanges.find(regName);
+            if(fit == currentLiveRanges.end() || !isOperandMasked(out)) {
+                operandLiveRanges.emplace_back(&out, beginLiveRange(regName, position));
+            } else {
+                liveRanges[fit->second].end = position;
+                operandLiveRanges.emplace_back(&out, fit->second);
+            }
+        }
+
+        position++;
+    }
+
+    // live ranges are created in the order of their beginning
+    std::vector<unsigned> physicalRegFreePositions;
+    m_allocatedTempRegDeclarations.clear();
+    m_allocatedTempRegContents.clear();
+    for(auto &liveRange: liveRanges) {
+        unsigned physicalRegIndex = 0;
+        while(physicalRegIndex < physicalRegFreePositions.size() &&
+            physicalRegFreePositions[physicalRegIndex] > liveRange.begin) {
+            physicalRegIndex++;
+        }
+
+        if(physicalRegIndex == physicalRegFreePositions.size()) {
+            physicalRegFreePositions.push_back(liveRange.end);
+            m_allocatedTempRegDeclarations.emplace_back("__$reg_" + std::to_string(physicalRegIndex));
+            m_allocatedTempRegContents.emplace_back();
+        } else {
+            physicalRegFreePositions[physicalRegIndex] = liveRange.end;
+        }
+        liveRange.physicalRegIndex = physicalRegIndex;
+
+        std::vector<std::string> &contents = m_allocatedTempRegContents[physicalRegIndex];
+        if(std::find(contents.begin(), contents.end(), liveRange.virtualRegName) == contents.end()) {
+            contents.push_back(liveRange.virtualRegName);
+        }
+    }
+
+    for(const auto &p: operandLiveRanges) {
+        const TempRegDeclaration &physicalReg = m_allocatedTempRegDeclarations[liveRanges[p.second].physicalRegIndex];
+        *p.first = renameOperandRegister(*p.first, physicalReg.getRegName());
+    }
+
+    // copies between live ranges sharing a physical TEMP, into the same components, are no-ops now
+    m_instructions.erase(std::remove_if(m_instructions.begin(), m_instructions.end(),
+        [](std::unique_ptr<Instruction> &ins) {
+            ARBInstruction *arbIns = dynamic_cast<ARBInstruction *>(ins.get());
+            if(arbIns == nullptr || arbIns->getOPCode() != OPCode::MOV) {
+                return false;
+            }
+            const std::string &out = arbIns->getOutput();
+            const std::string &in = *arbIns->getInputs().at(0);
+            if(in[0] == '-' || getOperandRegisterName(out) != getOperandRegisterName(in)) {
+                return false;
+            }
+
+            // a write mask lists the written components in order
+            std::array<unsigned, 4> writtenComponents = getOperandComponents(out);
+            std::array<unsigned, 4> readComponents = getOperandComponents(in);
+            std::string mask = isOperandMasked(out) ? out.substr(out.find('.') + 1) : "xyzw";
+            for(unsigned i = 0; i < mask.size(); i++) {
+                if(readComponents[writtenComponents[i]] != writtenComponents[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }),
+        m_instructions.end());
+
+    m_tempRegistersAllocated = true;
+}
+
+
+/* Drops every TEMP and PARAM declaration that no instruction refers to */
+void ARBAssemblyDatabase::removeUnusedDeclarations() {
+    std::unordered_set<std::string> usedRegNames;
+    for(auto &ins: m_instructions) {
+        ARBInstruction *arbIns = dynamic_cast<ARBInstruction *>(ins.get());
+        if(arbIns == nullptr) {
+            continue;
+        }
+
+        usedRegNames.insert(getOperandRegisterName(arbIns->getOutput()));
+        for(std::string *in: arbIns->getInputs()) {
+            usedRegNames.insert(getOperandRegisterName(*in));
+        }
+    }
+
+    auto removeUnused = [&](auto &declarations) {
+        declarations.erase(std::remove_if(declarations.begin(), declarations.end(),
+            [&](const auto &declaration) { return usedRegNames.count(declaration.getRegName()) == 0; }),
+            declarations.end());
+    };
+    removeUnused(m_userTempRegDeclarations);
+    removeUnused(m_autoTempRegDeclarations);
+    removeUnused(m_constantPool);
+    removeUnused(m_allocatedTempRegDeclarations);
+}
+
 
 /* Flattened symbol table with resolved symbol names */
 class DeclaredSymbolRegisterTable {
     public:
-        using NameToDeclHashTable = std::unordered_map<std::string, const AST::DeclarationNode *>;
         using DeclToNameHashTable = std::unordered_map<const AST::DeclarationNode *, std::string>;
     
     private:
-        NameToDeclHashTable m_regNameToDecl;
         DeclToNameHashTable m_declToregName;
+        std::unordered_map<AST::SymbolID, unsigned> m_symbolDeclarationCount;
+        std::vector<const AST::DeclarationNode *> m_declarationOrder;
     
     public:
-        bool hasRegisterName(const std::string &regName) const {
-            return (m_regNameToDecl.count(regName) == 1);
+        /* Number of earlier declarations of the symbol */
+        unsigned countDeclaration(AST::SymbolID symbol) {
+            return m_symbolDeclarationCount[symbol]++;
         }
 
         bool hasDeclaration(const AST::DeclarationNode *decl) const {
@@ -492,24 +858,20 @@ class DeclaredSymbolRegisterTable {
         }
 
         void insert(const std::string &regName, const AST::DeclarationNode *decl) {
-            assert(!hasRegisterName(regName));
             assert(!hasDeclaration(decl));
 
-            m_regNameToDecl.emplace(regName, decl);
             m_declToregName.emplace(decl, regName);
-
-            assert(m_regNameToDecl.size() == m_declToregName.size());
+            m_declarationOrder.push_back(decl);
         }
     
     public:
-        const NameToDeclHashTable &getRegNameToDeclMapping()const { return m_regNameToDecl; }
         const DeclToNameHashTable &getDeclToregNameMapping()const { return m_declToregName; }
 
     public:
         void print() const {
-            for(const auto &p : m_regNameToDecl) {
-                printf("%s : ", p.first.c_str());
-                ast_print(const_cast<AST::DeclarationNode *>(p.second));
+            for(const AST::DeclarationNode *decl: m_declarationOrder) {
+                printf("%s : ", getRegisterName(decl).c_str());
+                ast_print(const_cast<AST::DeclarationNode *>(decl));
                 printf("\n");
             }
         }
@@ -536,14 +898,9 @@ DeclaredSymbolRegisterTable createDeclaredSymbolRegisterTable(AST::ASTNode *astN
                 std::string symbolDeclaredName = declarationNode->getName();
                 std::string symbolRegisterName = m_symbolNamePrefix + symbolDeclaredName;
 
-                std::string symbolRegisterResolvedName = symbolRegisterName;
-                
-                // avoid same symbol declaration name
-                unsigned duplicate_count = 0;
-                do{
-                    symbolRegisterResolvedName = symbolRegisterName + "_" + std::to_string(duplicate_count);
-                    duplicate_count++;
-                }while(m_declaredSymbolRegisterTable.hasRegisterName(symbolRegisterResolvedName));
+                // avoid same symbol declaration name, the numeric suffix after the last '_' keeps different symbols apart
+                unsigned duplicate_count = m_declaredSymbolRegisterTable.countDeclaration(declarationNode->getSymbolID());
+                std::string symbolRegisterResolvedName = symbolRegisterName + "_" + std::to_string(duplicate_count);
 
                 m_declaredSymbolRegisterTable.insert(symbolRegisterResolvedName, declarationNode);
             }
@@ -556,124 +913,66 @@ DeclaredSymbolRegisterTable createDeclaredSymbolRegisterTable(AST::ASTNode *astN
 }
 
 
-class ConstQualifiedExpressionReducer: public AST::Visitor {
-    private:
-        const DeclaredSymbolRegisterTable &m_declaredSymbolRegisterTable;
-
-        std::string m_assemblyValue; // for const qualifed values
-        bool m_successful = true;
-
-    private:
-        ConstQualifiedExpressionReducer(const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable):
-            m_declaredSymbolRegisterTable(declaredSymbolRegisterTable) {}
+/* Current SSA value of each non-constant variable */
+using VariableValueTable = std::unordered_map<const AST::DeclarationNode *, IR::Value *>;
 
-    private:
-        virtual void preNodeVisit(AST::ExpressionsNode *expressionsNode){
-            m_assemblyValue += "{";
-        }
-
-    private:
-        virtual void postNodeVisit(AST::ExpressionsNode *expressionsNode){
-            m_assemblyValue += "}";
-        }
-
-        virtual void postNodeVisit(AST::UnaryExpressionNode *unaryExpressionNode){
-            m_successful = false;
-        }
-
-        virtual void postNodeVisit(AST::BinaryExpressionNode *binaryExpressionNode){
-            m_successful = false;
-        }
-
-        virtual void postNodeVisit(AST::IntLiteralNode *intLiteralNode){
-            m_assemblyValue += std::to_string(static_cast<float>(intLiteralNode->getVal()));
-        }
-
-        virtual void postNodeVisit(AST::FloatLiteralNode *floatLiteralNode){
-            m_assemblyValue += std::to_string(floatLiteralNode->getVal());
-        }
+int getBooleanDataType(unsigned numberComponents) {
+    switch(numberComponents) {
+        case 1: return BOOL_T;
+        case 2: return BVEC2_T;
+        case 3: return BVEC3_T;
+        case 4: return BVEC4_T;
+        default:
+            assert(0);
+    }
+    return BOOL_T;
+}
 
-        virtual void postNodeVisit(AST::BooleanLiteralNode *booleanLiteralNode){
-            m_assemblyValue += std::to_string(booleanLiteralNode->getVal() ? 1.0 : -1.0);
-        }
-
-        virtual void postNodeVisit(AST::IdentifierNode *identifierNode){
-            const AST::DeclarationNode *decl = identifierNode->getDeclaration();
-            if(decl->isOrdinaryType()) {
-                if(!decl->isConst()) {
-                    m_successful = false;
-                    return;
-                }
-
-                // const ordinary type
-                const AST::DeclarationNode *decl = identifierNode->getDeclaration();
-                AST::ExpressionNode *initExpr = (decl->getInitValue()) ? decl->getInitValue(): decl->getExpression();
-                initExpr->visit(*this);
-            } else {
-                // predefined variable
-                m_assemblyValue += m_declaredSymbolRegisterTable.getRegisterName(identifierNode->getDeclaration());
-            }
-        }
-        
-        virtual void postNodeVisit(AST::IndexingNode *indexingNode){
-            m_assemblyValue += "." +
-                getRegisterIndexing(dynamic_cast<AST::IntLiteralNode *>(indexingNode->getIndexExpression())->getVal());
-        }
-        
-        virtual void postNodeVisit(AST::FunctionNode *functionNode){
-            m_successful = false;
+/* Components of a compile-time value as held by ARB registers */
+std::array<float, 4> getConstantValues(const SEMA::DataContainer &data) {
+    std::array<float, 4> values = {{0.0, 0.0, 0.0, 0.0}};
+    for(int i = 0; i < data.getTypeOrder(); i++) {
+        switch(data.getTypeBase()) {
+            case INT_T:
+                values[i] = static_cast<float>(data.getIntVal()[i]);
+                break;
+            case FLOAT_T:
+                values[i] = data.getFloatVal()[i];
+                break;
+            case BOOL_T:
+                values[i] = data.getBoolVal()[i] ? 1.0 : -1.0;
+                break;
+            default:
+                assert(0);
         }
+    }
+    return values;
+}
 
-    private:
-        virtual void nodeVisit(AST::ExpressionsNode *expressionsNode) {
-            int counter = 0;
-            for(AST::ExpressionNode *expr: expressionsNode->getExpressionList()) {
-                if(counter != 0) {
-                    m_assemblyValue += ",";
-                }
-                expr->visit(*this);
-                counter++;
-            }
-        }
-        virtual void nodeVisit(AST::IndexingNode *indexingNode) {
-            indexingNode->getIdentifier()->visit(*this);
-        }
-        virtual void nodeVisit(AST::FunctionNode *functionNode) {}
+/* The scalar held by the first swizzled component, replicated to all components */
+IR::Operand getReplicatedOperand(const IR::Operand &operand) {
+    return IR::Operand(operand.value, IR::Swizzle::replicate(operand.swizzle.getComponent(0)), operand.negate);
+}
 
-    public:
-        /* Reduce the expression to value */
-        static std::string reduceToValue(const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable, AST::ExpressionNode *expr) {
-            ConstQualifiedExpressionReducer reducer(declaredSymbolRegisterTable);
-            expr->visit(reducer);
-            if(reducer.m_successful) {
-                return reducer.m_assemblyValue;
-            } else {
-                std::string assemblyValue = "{";
-                int dataTypeOrder = SEMA::getDataTypeOrder(expr->getExpressionType());
-                for(int i = 0; i < dataTypeOrder; i++) {
-                    if(i != 0) {
-                        assemblyValue += ",";
-                    }
-                    assemblyValue += "0.0";
-                }
-                assemblyValue += "}";
-                return assemblyValue;
-            }
-        }
-};
+IR::Operand getNegatedOperand(const IR::Operand &operand) {
+    return IR::Operand(operand.value, operand.swizzle, !operand.negate);
+}
 
 
 class ExpressionReducer: public AST::Visitor {
     private:
         const DeclaredSymbolRegisterTable &m_declaredSymbolRegisterTable;
-        ARBAssemblyDatabase &m_assemblyDB;
+        const VariableValueTable &m_variableValueTable;
+        IR::Program &m_program;
 
-        std::string m_resultRegName;
+        IR::Operand m_result;
 
     private:
-        ExpressionReducer(const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable, ARBAssemblyDatabase &assemblyDB):
-            m_declaredSymbolRegisterTable(declaredSymbolRegisterTable), m_assemblyDB(assemblyDB) {}
-        
+        ExpressionReducer(const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable,
+            const VariableValueTable &variableValueTable,
+            IR::Program &program):
+            m_declaredSymbolRegisterTable(declaredSymbolRegisterTable), m_variableValueTable(variableValueTable), m_program(program) {}
+
     private:
         /* Disable traversal, we do reduction here */
         virtual void nodeVisit(AST::UnaryExpressionNode *unaryExpressionNode);
@@ -686,228 +985,276 @@ class ExpressionReducer: public AST::Visitor {
         virtual void nodeVisit(AST::FunctionNode *functionNode);
         virtual void nodeVisit(AST::ConstructorNode *constructorNode);
 
-    
+    private:
+        IR::Operand reduce(AST::ExpressionNode *expr) {
+            return reduce(m_declaredSymbolRegisterTable, m_variableValueTable, m_program, expr);
+        }
+
+        /* Scalar operands of vector instructions are replicated */
+        IR::Operand getSourceOperand(AST::ExpressionNode *expr, const IR::Operand &operand, int resultType) const {
+            if(SEMA::getDataTypeOrder(expr->getExpressionType()) == 1 && SEMA::getDataTypeOrder(resultType) > 1) {
+                return getReplicatedOperand(operand);
+            }
+            return operand;
+        }
+
+        IR::Operand createComparison(int op, const IR::Operand &lhs, const IR::Operand &rhs, int operandType);
+
     public:
-        /* Reduce the expression into a register containing the expression result */
-        static std::string reduce(const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable,
-            ARBAssemblyDatabase &assemblyDB,
+        /* Reduce the expression into an operand containing the expression result */
+        static IR::Operand reduce(const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable,
+            const VariableValueTable &variableValueTable,
+            IR::Program &program,
             AST::ExpressionNode *expr);
 };
 
 void ExpressionReducer::nodeVisit(AST::UnaryExpressionNode *unaryExpressionNode) {
-    std::string rhsRegName = reduce(m_declaredSymbolRegisterTable,
-        m_assemblyDB,
-        unaryExpressionNode->getExpression());
-    
-    m_resultRegName = m_assemblyDB.requestAutoTempRegister();
+    IR::Operand rhs = reduce(unaryExpressionNode->getExpression());
 
     assert(unaryExpressionNode->getOperator() == MINUS || unaryExpressionNode->getOperator() == NOT);
-    m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, m_resultRegName, "-" + rhsRegName);
+    m_result = m_program.createInstruction(unaryExpressionNode->getExpressionType(), IR::Opcode::MOV, {getNegatedOperand(rhs)});
 }
 
 void ExpressionReducer::nodeVisit(AST::BinaryExpressionNode *binaryExpressionNode) {
-    std::string lhsRegName = reduce(m_declaredSymbolRegisterTable,
-    m_assemblyDB,
-    binaryExpressionNode->getLeftExpression());
+    AST::ExpressionNode *lhsExpr = binaryExpressionNode->getLeftExpression();
+    AST::ExpressionNode *rhsExpr = binaryExpressionNode->getRightExpression();
+    int resultType = binaryExpressionNode->getExpressionType();
 
-    std::string rhsRegName = reduce(m_declaredSymbolRegisterTable,
-    m_assemblyDB,
-    binaryExpressionNode->getRightExpression());
-
-    m_resultRegName = m_assemblyDB.requestAutoTempRegister();
+    IR::Operand lhs = getSourceOperand(lhsExpr, reduce(lhsExpr), resultType);
+    IR::Operand rhs = getSourceOperand(rhsExpr, reduce(rhsExpr), resultType);
 
     switch(binaryExpressionNode->getOperator()) {
         case AND:
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MIN, m_resultRegName, lhsRegName, rhsRegName);
+            m_result = m_program.createInstruction(resultType, IR::Opcode::MIN, {lhs, rhs});
             break;
         case OR:
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MAX, m_resultRegName, lhsRegName, rhsRegName);
+            m_result = m_program.createInstruction(resultType, IR::Opcode::MAX, {lhs, rhs});
             break;
         case PLUS:
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::ADD, m_resultRegName, lhsRegName, rhsRegName);
+            m_result = m_program.createInstruction(resultType, IR::Opcode::ADD, {lhs, rhs});
             break;
         case MINUS:
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::SUB, m_resultRegName, lhsRegName, rhsRegName);
+            m_result = m_program.createInstruction(resultType, IR::Opcode::SUB, {lhs, rhs});
             break;
         case TIMES:
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MUL, m_resultRegName, lhsRegName, rhsRegName);
+            m_result = m_program.createInstruction(resultType, IR::Opcode::MUL, {lhs, rhs});
             break;
         case SLASH: {
-            std::string rcpResult = m_assemblyDB.requestAutoTempRegister();
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::RCP, rcpResult, rhsRegName);
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MUL, m_resultRegName, lhsRegName, rcpResult);
+            IR::Instruction *rcpResult = m_program.createInstruction(rhsExpr->getExpressionType(), IR::Opcode::RCP, {rhs});
+            m_result = m_program.createInstruction(resultType, IR::Opcode::MUL, {lhs, getSourceOperand(rhsExpr, rcpResult, resultType)});
             break;
         }
         case EXP:
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::POW, m_resultRegName, lhsRegName, rhsRegName);
+            m_result = m_program.createInstruction(resultType, IR::Opcode::POW, {lhs, rhs});
             break;
-        case EQL: {
-            std::string tempReg = m_assemblyDB.requestAutoTempRegister();
-            // represent their difference as negative number
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::SUB, tempReg, lhsRegName, rhsRegName);
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::ABS, tempReg, tempReg);
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, tempReg, "-" + tempReg);
-            
-            // component-wise eql comparison
-            std::string trueReg = m_assemblyDB.getAutoTrueParamRegister();
-            std::string falseReg = m_assemblyDB.getAutoFalseParamRegister();
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::CMP, tempReg, tempReg, falseReg, trueReg);
+        case EQL:
+        case NEQ:
+        case LSS:
+        case GEQ:
+        case GTR:
+        case LEQ:
+            m_result = createComparison(binaryExpressionNode->getOperator(), lhs, rhs, lhsExpr->getExpressionType());
+            break;
+        default:
+            assert(0);
+    }
+}
 
-            // and them up
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MIN, tempReg + ".x", tempReg + ".x", tempReg + ".y");
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MIN, tempReg + ".x", tempReg + ".x", tempReg + ".z");
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MIN, tempReg + ".x", tempReg + ".x", tempReg + ".w");
+IR::Operand ExpressionReducer::createComparison(int op, const IR::Operand &lhs, const IR::Operand &rhs, int operandType) {
+    IR::Operand trueOperand = m_program.getTrueConstant();
+    IR::Operand falseOperand = m_program.getFalseConstant();
 
-            // store result
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, m_resultRegName, tempReg);
+    switch(op) {
+        case EQL:
+        case NEQ: {
+            unsigned numberComponents = SEMA::getDataTypeOrder(operandType);
+            int booleanType = getBooleanDataType(numberComponents);
 
-            break;
-        }
-        case NEQ: { // negate of EQL
-            std::string tempReg = m_assemblyDB.requestAutoTempRegister();
             // represent their difference as negative number
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::SUB, tempReg, lhsRegName, rhsRegName);
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::ABS, tempReg, tempReg);
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, tempReg, "-" + tempReg);
-            
+            IR::Instruction *diff = m_program.createInstruction(operandType, IR::Opcode::SUB, {lhs, rhs});
+            diff = m_program.createInstruction(operandType, IR::Opcode::ABS, {diff});
+
+            // sum up the absolute differences with one dot product, cheaper than and-ing 3 or 4 components
+            if(numberComponents >= 3) {
+                IR::Operand ones = m_program.createConstant(VEC4_T, {{1.0, 1.0, 1.0, 1.0}});
+                IR::Opcode dotOpcode = (numberComponents == 3) ? IR::Opcode::DP3 : IR::Opcode::DP4;
+                diff = m_program.createInstruction(FLOAT_T, dotOpcode, {diff, ones});
+                numberComponents = 1;
+                booleanType = BOOL_T;
+            }
+            diff = m_program.createInstruction(diff->getDataType(), IR::Opcode::MOV, {getNegatedOperand(diff)});
+
             // component-wise eql comparison
-            std::string trueReg = m_assemblyDB.getAutoTrueParamRegister();
-            std::string falseReg = m_assemblyDB.getAutoFalseParamRegister();
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::CMP, tempReg, tempReg, falseReg, trueReg);
+            IR::Instruction *eql = m_program.createInstruction(booleanType, IR::Opcode::CMP, {diff, falseOperand, trueOperand});
 
             // and them up
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MIN, tempReg + ".x", tempReg + ".x", tempReg + ".y");
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MIN, tempReg + ".x", tempReg + ".x", tempReg + ".z");
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MIN, tempReg + ".x", tempReg + ".x", tempReg + ".w");
-
-            // store result, negate the EQL operation
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, m_resultRegName, "-" + tempReg);
+            for(unsigned i = 1; i < numberComponents; i++) {
+                IR::Instruction *prevEql = eql;
+                eql = m_program.createInstruction(booleanType, IR::Opcode::MIN,
+                    {IR::Operand(prevEql, IR::Swizzle::replicate(0)), IR::Operand(prevEql, IR::Swizzle::replicate(i))});
+                eql->setWriteMask(IR::getFullWriteMask(1), prevEql);
+            }
 
-            break;
+            // store result, negate for NEQ
+            IR::Operand result(eql, IR::Swizzle(), op == NEQ);
+            return m_program.createInstruction(BOOL_T, IR::Opcode::MOV, {result});
         }
         case LSS: {
-            std::string tempReg = m_assemblyDB.requestAutoTempRegister();
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::SUB, tempReg, lhsRegName, rhsRegName);
+            IR::Instruction *diff = m_program.createInstruction(operandType, IR::Opcode::SUB, {lhs, rhs});
             // < 0 if lss
-            std::string trueReg = m_assemblyDB.getAutoTrueParamRegister();
-            std::string falseReg = m_assemblyDB.getAutoFalseParamRegister();
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::CMP, m_resultRegName, tempReg, trueReg, falseReg);
-
-            break;
+            return m_program.createInstruction(BOOL_T, IR::Opcode::CMP, {diff, trueOperand, falseOperand});
         }
         case GEQ: { // negate of LSS
-            std::string tempReg = m_assemblyDB.requestAutoTempRegister();
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::SUB, tempReg, lhsRegName, rhsRegName);
+            IR::Instruction *diff = m_program.createInstruction(operandType, IR::Opcode::SUB, {lhs, rhs});
             // < 0 if lss
-            std::string trueReg = m_assemblyDB.getAutoTrueParamRegister();
-            std::string falseReg = m_assemblyDB.getAutoFalseParamRegister();
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::CMP, m_resultRegName, tempReg, falseReg, trueReg);
-
-            break;
+            return m_program.createInstruction(BOOL_T, IR::Opcode::CMP, {diff, falseOperand, trueOperand});
         }
         case GTR: {
-            std::string tempReg = m_assemblyDB.requestAutoTempRegister();
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::SUB, tempReg, rhsRegName, lhsRegName);
+            IR::Instruction *diff = m_program.createInstruction(operandType, IR::Opcode::SUB, {rhs, lhs});
             // < 0 if gtr
-            std::string trueReg = m_assemblyDB.getAutoTrueParamRegister();
-            std::string falseReg = m_assemblyDB.getAutoFalseParamRegister();
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::CMP, m_resultRegName, tempReg, trueReg, falseReg);
-
-            break;
+            return m_program.createInstruction(BOOL_T, IR::Opcode::CMP, {diff, trueOperand, falseOperand});
         }
         case LEQ: { // negate of GTR
-            std::string tempReg = m_assemblyDB.requestAutoTempRegister();
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::SUB, tempReg, rhsRegName, lhsRegName);
+            IR::Instruction *diff = m_program.createInstruction(operandType, IR::Opcode::SUB, {rhs, lhs});
             // < 0 if gtr
-            std::string trueReg = m_assemblyDB.getAutoTrueParamRegister();
-            std::string falseReg = m_assemblyDB.getAutoFalseParamRegister();
-            m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::CMP, m_resultRegName, tempReg, falseReg, trueReg);
-
-            break;
+            return m_program.createInstruction(BOOL_T, IR::Opcode::CMP, {diff, falseOperand, trueOperand});
         }
         default:
             assert(0);
     }
+    return IR::Operand();
 }
 
 void ExpressionReducer::nodeVisit(AST::IntLiteralNode *intLiteralNode) {
-    m_resultRegName = m_assemblyDB.requestAutoParamRegister(
-        ConstQualifiedExpressionReducer::reduceToValue(m_declaredSymbolRegisterTable, intLiteralNode));
+    float val = static_cast<float>(intLiteralNode->getVal());
+    m_result = m_program.createConstant(INT_T, {{val, 0.0, 0.0, 0.0}});
 }
 
 void ExpressionReducer::nodeVisit(AST::FloatLiteralNode *floatLiteralNode) {
-    m_resultRegName = m_assemblyDB.requestAutoParamRegister(
-        ConstQualifiedExpressionReducer::reduceToValue(m_declaredSymbolRegisterTable, floatLiteralNode));
+    float val = floatLiteralNode->getVal();
+    m_result = m_program.createConstant(FLOAT_T, {{val, 0.0, 0.0, 0.0}});
 }
 
 void ExpressionReducer::nodeVisit(AST::BooleanLiteralNode *booleanLiteralNode) {
-    m_resultRegName = m_assemblyDB.requestAutoParamRegister(
-        ConstQualifiedExpressionReducer::reduceToValue(m_declaredSymbolRegisterTable, booleanLiteralNode));
+    float val = booleanLiteralNode->getVal() ? 1.0 : -1.0;
+    m_result = m_program.createConstant(BOOL_T, {{val, 0.0, 0.0, 0.0}});
 }
 
 void ExpressionReducer::nodeVisit(AST::IdentifierNode *identifierNode) {
-    m_resultRegName = m_declaredSymbolRegisterTable.getRegisterName(identifierNode->getDeclaration());
+    const AST::DeclarationNode *decl = identifierNode->getDeclaration();
+    if(decl->isOrdinaryType() && !decl->isConst()) {
+        auto fit = m_variableValueTable.find(decl);
+        // read of an unassigned variable (self-initialization) is undefined, use zero
+        m_result = (fit != m_variableValueTable.end()) ? fit->second : m_program.getZeroConstant();
+    } else if(decl->isOrdinaryType()) {
+        // const qualified variables are their initial values, which are constant expressions
+        AST::ExpressionNode *initExpr = (decl->getInitValue()) ? decl->getInitValue(): decl->getExpression();
+        m_result = reduce(initExpr);
+    } else {
+        // predefined variables live in named registers
+        m_result = m_program.createRegister(decl->getType(), m_declaredSymbolRegisterTable.getRegisterName(decl));
+    }
 }
 
 void ExpressionReducer::nodeVisit(AST::IndexingNode *indexingNode) {
-    m_resultRegName = m_declaredSymbolRegisterTable.getRegisterName(indexingNode->getDeclaration());
-    m_resultRegName += "." +
-                getRegisterIndexing(dynamic_cast<AST::IntLiteralNode *>(indexingNode->getIndexExpression())->getVal());
+    IR::Operand vector = reduce(indexingNode->getIdentifier());
+    unsigned index = dynamic_cast<AST::IntLiteralNode *>(indexingNode->getIndexExpression())->getVal();
+
+    m_result = IR::Operand(vector.value, IR::Swizzle::replicate(vector.swizzle.getComponent(index)), vector.negate);
 }
 
 void ExpressionReducer::nodeVisit(AST::FunctionNode *functionNode) {
-    const std::string &funcName = functionNode->getName();
+    AST::SymbolID funcName = functionNode->getSymbolID();
     AST::ExpressionsNode *exprs = functionNode->getArgumentExpressions();
-    if(funcName == "rsq") {
-        m_resultRegName = m_assemblyDB.requestAutoTempRegister();
+    int resultType = functionNode->getExpressionType();
+    if(funcName == l_rsqFunctionName) {
         assert(exprs->getNumberExpression() == 1);
-        std::string arg1RegName = reduce(m_declaredSymbolRegisterTable, m_assemblyDB, exprs->getExpressionAt(0));
+        IR::Operand arg1 = reduce(exprs->getExpressionAt(0));
 
-        m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::RSQ, m_resultRegName, arg1RegName);
-    } else if (funcName == "dp3") {
-        m_resultRegName = m_assemblyDB.requestAutoTempRegister();
+        m_result = m_program.createInstruction(resultType, IR::Opcode::RSQ, {arg1});
+    } else if (funcName == l_dp3FunctionName) {
         assert(exprs->getNumberExpression() == 2);
-        std::string arg1RegName = reduce(m_declaredSymbolRegisterTable, m_assemblyDB, exprs->getExpressionAt(0));
-        std::string arg2RegName = reduce(m_declaredSymbolRegisterTable, m_assemblyDB, exprs->getExpressionAt(1));
+        IR::Operand arg1 = reduce(exprs->getExpressionAt(0));
+        IR::Operand arg2 = reduce(exprs->getExpressionAt(1));
 
-        m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::DP3, m_resultRegName, arg1RegName, arg2RegName);
-    } else if (funcName == "lit") {
-        m_resultRegName = m_assemblyDB.requestAutoTempRegister();
+        m_result = m_program.createInstruction(resultType, IR::Opcode::DP3, {arg1, arg2});
+    } else if (funcName == l_litFunctionName) {
         assert(exprs->getNumberExpression() == 1);
-        std::string arg1RegName = reduce(m_declaredSymbolRegisterTable, m_assemblyDB, exprs->getExpressionAt(0));
+        IR::Operand arg1 = reduce(exprs->getExpressionAt(0));
 
-        m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::LIT, m_resultRegName, arg1RegName);
+        m_result = m_program.createInstruction(resultType, IR::Opcode::LIT, {arg1});
     } else {
         assert(0);
     }
 }
 
 void ExpressionReducer::nodeVisit(AST::ConstructorNode *constructorNode) {
-    m_resultRegName = m_assemblyDB.requestAutoParamRegister(
-        ConstQualifiedExpressionReducer::reduceToValue(m_declaredSymbolRegisterTable, constructorNode));
+    int resultType = constructorNode->getExpressionType();
+    const AST::ExpressionList &exprs = constructorNode->getArgumentExpressions()->getExpressionList();
+
+    std::vector<IR::Operand> args;
+    bool isAllConstant = true;
+    for(AST::ExpressionNode *expr: exprs) {
+        args.push_back(reduce(expr));
+        isAllConstant = isAllConstant && args.back().value->isConstant();
+    }
+
+    if(isAllConstant) {
+        std::array<float, 4> values = {{0.0, 0.0, 0.0, 0.0}};
+        for(unsigned i = 0; i < args.size(); i++) {
+            const IR::Constant *constant = static_cast<const IR::Constant *>(args[i].value);
+            float val = constant->getValueAt(args[i].swizzle.getComponent(0));
+            values[i] = args[i].negate ? -val : val;
+        }
+        m_result = m_program.createConstant(resultType, values);
+        return;
+    }
+
+    // insert the components one by one
+    IR::Instruction *vector = nullptr;
+    for(unsigned i = 0; i < args.size(); i++) {
+        IR::Instruction *prevVector = vector;
+        vector = m_program.createInstruction(resultType, IR::Opcode::MOV, {getReplicatedOperand(args[i])});
+        vector->setWriteMask(1u << i, prevVector);
+    }
+    m_result = vector;
 }
 
-std::string ExpressionReducer::reduce(const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable,
-            ARBAssemblyDatabase &assemblyDB,
+IR::Operand ExpressionReducer::reduce(const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable,
+            const VariableValueTable &variableValueTable,
+            IR::Program &program,
             AST::ExpressionNode *expr) {
-    ExpressionReducer reducer(declaredSymbolRegisterTable, assemblyDB);
+    // fold constant expressions into a single immediate value
+    if(expr->isConst()) {
+        SEMA::DataContainer data(expr->getExpressionType());
+        if(SEMA::evaluateConstantExpression(expr, data)) {
+            return program.createConstant(expr->getExpressionType(), getConstantValues(data));
+        }
+    }
+
+    ExpressionReducer reducer(declaredSymbolRegisterTable, variableValueTable, program);
     expr->visit(reducer);
-    return reducer.m_resultRegName;
+    assert(reducer.m_result.isValid());
+    return reducer.m_result;
 }
 
 
-void sendInstructionToAssemblyDB(ARBAssemblyDatabase &assemblyDB, const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable, AST::ASTNode *ast) {
+IR::Program createIRProgram(const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable, AST::ASTNode *ast) {
     class AssignmentVisitor: public AST::Visitor {
         private:
             const DeclaredSymbolRegisterTable &m_declaredSymbolRegisterTable;
-            ARBAssemblyDatabase &m_assemblyDB;
+            IR::Program &m_program;
 
-            std::string m_currentConditionReg;
+            VariableValueTable m_variableValueTable;
+            IR::Operand m_currentCondition;
             int m_ifScopeCount = 0;
 
+            // conditions of the iterations of the loops being unrolled, assumed true to bound their trip counts
+            std::unordered_map<const IR::Value *, std::array<float, 4>> m_assumedLoopConditions;
+
         public:
-            AssignmentVisitor(const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable, ARBAssemblyDatabase &assemblyDB):
-                m_declaredSymbolRegisterTable(declaredSymbolRegisterTable), m_assemblyDB(assemblyDB) {}
+            AssignmentVisitor(const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable, IR::Program &program):
+                m_declaredSymbolRegisterTable(declaredSymbolRegisterTable), m_program(program) {}
 
         private:
             /* Disable traversal for expressions */
@@ -924,141 +1271,518 @@ void sendInstructionToAssemblyDB(ARBAssemblyDatabase &assemblyDB, const Declared
             virtual void nodeVisit(AST::FunctionNode *functionNode) {}
             virtual void nodeVisit(AST::ConstructorNode *constructorNode) {}
 
-            virtual void preNodeVisit(AST::ScopeNode *scopeNode) {
-                m_currentConditionReg = m_assemblyDB.getAutoTrueParamRegister();
+        private:
+            IR::Operand reduce(AST::ExpressionNode *expr) {
+                return ExpressionReducer::reduce(m_declaredSymbolRegisterTable, m_variableValueTable, m_program, expr);
             }
 
+            /* Annotate the first instruction created since instructionCount */
+            void annotate(unsigned instructionCount, const std::vector<std::string> &annotations) {
+                if(instructionCount < m_program.getInstructions().size()) {
+                    for(const std::string &annotation: annotations) {
+                        m_program.getInstructions()[instructionCount]->addAnnotation(annotation);
+                    }
+                }
+            }
+
+            /* Predicated assignment under the current condition */
+            void assign(const AST::DeclarationNode *decl, const IR::Operand &value, IR::WriteMask writeMask) {
+                auto fit = m_variableValueTable.find(decl);
+                IR::Value *prevValue = (fit == m_variableValueTable.end()) ? nullptr : fit->second;
+
+                IR::Instruction *newValue = m_program.createInstruction(decl->getType(), IR::Opcode::MOV, {value});
+                if(writeMask != IR::getFullWriteMask(newValue->getNumberComponents())) {
+                    newValue->setWriteMask(writeMask, prevValue);
+                }
+                // if the previous value is undefined, any value will do
+                if(m_ifScopeCount != 0 && prevValue != nullptr) {
+                    newValue->setPredicate(m_currentCondition, prevValue);
+                }
+
+                if(decl->isResultType()) {
+                    m_program.setOutput(m_declaredSymbolRegisterTable.getRegisterName(decl), newValue);
+                } else {
+                    newValue->setVariableName(m_declaredSymbolRegisterTable.getRegisterName(decl));
+                }
+                m_variableValueTable[decl] = newValue;
+            }
+
+        private:
             virtual void nodeVisit(AST::IfStatementNode *ifStatementNode) {
                 m_ifScopeCount++;
 
                 // save previous
-                std::string previousConditionReg = std::move(m_currentConditionReg);
+                IR::Operand previousCondition = m_currentCondition;
 
-                m_assemblyDB.newAutoTempRegisterAllocationSession();
-                m_assemblyDB.insertInstructionComment("");
-                m_assemblyDB.insertInstructionComment("Evaluate if statement condition");
+                unsigned instructionCount = m_program.getInstructions().size();
+                IR::Operand cond = reduce(ifStatementNode->getConditionExpression());
 
-                std::string condReg = ExpressionReducer::reduce(m_declaredSymbolRegisterTable, m_assemblyDB,
-                    ifStatementNode->getConditionExpression());
-                std::string ownedCondReg = m_assemblyDB.requestAutoTempRegister();
                 // convert scalar condition to vector condition
-                m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, ownedCondReg + ".x", condReg + ".x");
-                m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, ownedCondReg + ".y", condReg + ".x");
-                m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, ownedCondReg + ".z", condReg + ".x");
-                m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, ownedCondReg + ".w", condReg + ".x");
-
-                m_currentConditionReg = m_assemblyDB.requestLongLiveAutoTempRegister();
-
+                IR::Instruction *ownedCond = nullptr;
+                for(unsigned i = 0; i < 4; i++) {
+                    IR::Instruction *prevOwnedCond = ownedCond;
+                    ownedCond = m_program.createInstruction(BVEC4_T, IR::Opcode::MOV, {getReplicatedOperand(cond)});
+                    ownedCond->setWriteMask(1u << i, prevOwnedCond);
+                }
+                annotate(instructionCount, {"", "Evaluate if statement condition"});
 
+                IR::Instruction *thenCond = nullptr;
                 if((m_ifScopeCount - 1) == 0) {
-                    m_assemblyDB.insertInstructionComment("Set the condition for outer-most if statement");
-                    m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV,
-                        m_currentConditionReg,
-                        ownedCondReg);
+                    thenCond = m_program.createInstruction(BVEC4_T, IR::Opcode::MOV, {ownedCond});
+                    thenCond->addAnnotation("Set the condition for outer-most if statement");
                 } else {
-                    // conditionally set the condition reg
-                    m_assemblyDB.insertInstructionComment("Conditionally set the condition for inner if statement");
-                    m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::CMP,
-                        m_currentConditionReg,
-                        previousConditionReg,
-                        previousConditionReg,                   // if outer condition is false, propagate false
-                        ownedCondReg                            // if outer condition is true, set new condition
-                        );
+                    // conditionally set the condition
+                    thenCond = m_program.createInstruction(BVEC4_T, IR::Opcode::CMP,
+                        {previousCondition,
+                         previousCondition,                    // if outer condition is false, propagate false
+                         ownedCond});                          // if outer condition is true, set new condition
+                    thenCond->addAnnotation("Conditionally set the condition for inner if statement");
                 }
+                m_currentCondition = thenCond;
 
                 ifStatementNode->getThenStatement()->visit(*this);
 
                 if(ifStatementNode->getElseStatement() != nullptr) {
-                    m_assemblyDB.insertInstructionComment("");
-
+                    IR::Instruction *elseCond = nullptr;
                     if((m_ifScopeCount - 1) == 0) {
-                        m_assemblyDB.insertInstructionComment("Negate the condition for outer-most else statement");
-                        m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV,
-                            m_currentConditionReg,
-                            "-" + m_currentConditionReg);
+                        elseCond = m_program.createInstruction(BVEC4_T, IR::Opcode::MOV, {getNegatedOperand(thenCond)});
+                        elseCond->addAnnotation("");
+                        elseCond->addAnnotation("Negate the condition for outer-most else statement");
                     } else {
-                        m_assemblyDB.insertInstructionComment("Conditionally negate the condition for inner else statement");
-                        m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::CMP,
-                            m_currentConditionReg,
-                            previousConditionReg,
-                            previousConditionReg,               // if outer condition is false, propagate false
-                            "-" + m_currentConditionReg         // if outer condition is true, flip the new condition
-                            );
+                        elseCond = m_program.createInstruction(BVEC4_T, IR::Opcode::CMP,
+                            {previousCondition,
+                             previousCondition,                // if outer condition is false, propagate false
+                             getNegatedOperand(thenCond)});    // if outer condition is true, flip the new condition
+                        elseCond->addAnnotation("");
+                        elseCond->addAnnotation("Conditionally negate the condition for inner else statement");
                     }
+                    m_currentCondition = elseCond;
+
                     ifStatementNode->getElseStatement()->visit(*this);
                 }
 
                 // restore previous
-                m_currentConditionReg = std::move(previousConditionReg);
+                m_currentCondition = previousCondition;
                 m_ifScopeCount--;
                 assert(m_ifScopeCount >= 0);
             }
 
-            virtual void nodeVisit(AST::DeclarationNode *declarationNode) {
-                if(declarationNode->isOrdinaryType() && !declarationNode->isConst()) {
-                    AST::ExpressionNode *initExpr = declarationNode->getExpression();
+            /*
+                Loops are fully unrolled, every iteration is an if statement nested in the previous one.
+                The trip count is bounded once the condition is known false, assuming every previous
+                iteration of the loop was taken, so early exits on unknown values are if-converted.
+            */
+            virtual void nodeVisit(AST::WhileStatementNode *whileStatementNode) {
+                m_ifScopeCount++;
 
-                    m_assemblyDB.newAutoTempRegisterAllocationSession();
-                    m_assemblyDB.insertInstructionComment("");
+                // save previous
+                IR::Operand previousCondition = m_currentCondition;
+
+                IR::Operand iterationCond = previousCondition;
+                std::vector<const IR::Value *> iterationConds;
+                unsigned loopInstructionCount = m_program.getInstructions().size();
+                for(unsigned iteration = 0; ; iteration++) {
+                    unsigned instructionCount = m_program.getInstructions().size();
+                    IR::Operand cond = reduce(whileStatementNode->getConditionExpression());
+
+                    std::array<float, 4> condValues;
+                    if(IR::evaluateOperand(cond, m_assumedLoopConditions, condValues) && condValues[0] < 0.0f) {
+                        break;
+                    }
 
-                    std::string lhsReg = m_declaredSymbolRegisterTable.getRegisterName(declarationNode);
-                    std::string rhsReg = initExpr ?
-                                        ExpressionReducer::reduce(m_declaredSymbolRegisterTable, m_assemblyDB, initExpr):
-                                        m_assemblyDB.getAutoZeroParamRegister();
+                    if(instructionCount - loopInstructionCount > static_cast<unsigned>(unrollBudget)) {
+                        fprintf(errorFile, "\nCODE GENERATION ERROR, LINE %d: While loop cannot be bounded within %d instructions, "
+                            "its condition is still not known false after %u iterations\n",
+                            whileStatementNode->getSourceLocation().firstLine, unrollBudget, iteration);
+                        errorOccurred = TRUE;
+                        break;
+                    }
 
-                    if(m_ifScopeCount == 0) {
-                        m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV,
-                            lhsReg,
-                            rhsReg);
+                    // convert scalar condition to vector condition
+                    IR::Instruction *ownedCond = nullptr;
+                    for(unsigned i = 0; i < 4; i++) {
+                        IR::Instruction *prevOwnedCond = ownedCond;
+                        ownedCond = m_program.createInstruction(BVEC4_T, IR::Opcode::MOV, {getReplicatedOperand(cond)});
+                        ownedCond->setWriteMask(1u << i, prevOwnedCond);
+                    }
+                    annotate(instructionCount, {"", "Evaluate while statement condition, iteration " + std::to_string(iteration)});
+
+                    IR::Instruction *thenCond = nullptr;
+                    if(!iterationCond.isValid()) {
+                        thenCond = m_program.createInstruction(BVEC4_T, IR::Opcode::MOV, {ownedCond});
                     } else {
-                        m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::CMP, 
-                            lhsReg,
-                            m_currentConditionReg,
-                            lhsReg, // if condition is false, no change
-                            rhsReg);
+                        // taken only if the enclosing condition and the previous iteration were
+                        thenCond = m_program.createInstruction(BVEC4_T, IR::Opcode::CMP,
+                            {iterationCond,
+                             iterationCond,                    // if outer condition is false, propagate false
+                             ownedCond});                      // if outer condition is true, set new condition
                     }
+                    m_assumedLoopConditions[thenCond] = {{1.0, 1.0, 1.0, 1.0}};
+                    iterationConds.push_back(thenCond);
+                    m_currentCondition = thenCond;
+                    iterationCond = thenCond;
+
+                    whileStatementNode->getBodyStatement()->visit(*this);
                 }
+
+                // code after the loop runs whether or not the iterations were taken
+                for(const IR::Value *cond: iterationConds) {
+                    m_assumedLoopConditions.erase(cond);
+                }
+
+                // restore previous
+                m_currentCondition = previousCondition;
+                m_ifScopeCount--;
+                assert(m_ifScopeCount >= 0);
             }
 
-            virtual void nodeVisit(AST::AssignmentNode *assignmentNode) {
-                m_assemblyDB.newAutoTempRegisterAllocationSession();
-                m_assemblyDB.insertInstructionComment("");
+            virtual void nodeVisit(AST::DeclarationNode *declarationNode) {
+                if(declarationNode->isOrdinaryType() && !declarationNode->isConst()) {
+                    AST::ExpressionNode *initExpr = declarationNode->getExpression();
+                    unsigned instructionCount = m_program.getInstructions().size();
 
+                    IR::Operand rhs = initExpr ? reduce(initExpr) : m_program.getZeroConstant();
+                    assign(declarationNode, rhs, IR::getFullWriteMask(SEMA::getDataTypeOrder(declarationNode->getType())));
+
+                    annotate(instructionCount, {""});
+                }
+            }
+
+            virtual void nodeVisit(AST::AssignmentNode *assignmentNode) {
                 AST::VariableNode *lhsVar = assignmentNode->getVariable();
                 AST::ExpressionNode *rhsExpr = assignmentNode->getExpression();
+                const AST::DeclarationNode *decl = lhsVar->getDeclaration();
+                unsigned instructionCount = m_program.getInstructions().size();
 
-                std::string lhsReg = ExpressionReducer::reduce(m_declaredSymbolRegisterTable, m_assemblyDB, lhsVar);
-                std::string rhsReg = ExpressionReducer::reduce(m_declaredSymbolRegisterTable, m_assemblyDB, rhsExpr);
+                IR::Operand rhs = reduce(rhsExpr);
 
-                if(m_ifScopeCount == 0) {
-                    m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV,
-                        lhsReg,
-                        rhsReg);
+                AST::IndexingNode *indexingNode = dynamic_cast<AST::IndexingNode *>(lhsVar);
+                if(indexingNode != nullptr) {
+                    unsigned index = dynamic_cast<AST::IntLiteralNode *>(indexingNode->getIndexExpression())->getVal();
+                    assign(decl, getReplicatedOperand(rhs), 1u << index);
                 } else {
-                    m_assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::CMP, 
-                        lhsReg,
-                        m_currentConditionReg,
-                        lhsReg, // if condition is false, no change
-                        rhsReg);
+                    assign(decl, rhs, IR::getFullWriteMask(SEMA::getDataTypeOrder(decl->getType())));
                 }
+
+                annotate(instructionCount, {""});
             }
     };
 
-    AssignmentVisitor visitor(declaredSymbolRegisterTable, assemblyDB);
+    IR::Program program;
+    AssignmentVisitor visitor(declaredSymbolRegisterTable, program);
     ast->visit(visitor);
-} 
+    program.verify();
+
+    return program;
+}
 
 
-void DeclaredSymbolRegisterTable::sendToAssemblyDB(ARBAssemblyDatabase &assemblyDB) const {      
-    for(const auto &p: m_regNameToDecl) {
-        const AST::DeclarationNode *decl = p.second;
-        if(decl->isOrdinaryType()) {
-            if(decl->isConst()) {
-                AST::ExpressionNode *initExpr = (decl->getInitValue()) ? decl->getInitValue(): decl->getExpression();
-                assemblyDB.declareUserParamRegister(p.first, ConstQualifiedExpressionReducer::reduceToValue(*this, initExpr));
+ARBAssemblyDatabase::OPCode getARBOpcode(IR::Opcode opCode) {
+    switch(opCode) {
+        case IR::Opcode::MOV: return ARBAssemblyDatabase::OPCode::MOV;
+        case IR::Opcode::ADD: return ARBAssemblyDatabase::OPCode::ADD;
+        case IR::Opcode::SUB: return ARBAssemblyDatabase::OPCode::SUB;
+        case IR::Opcode::MUL: return ARBAssemblyDatabase::OPCode::MUL;
+        case IR::Opcode::RCP: return ARBAssemblyDatabase::OPCode::RCP;
+        case IR::Opcode::POW: return ARBAssemblyDatabase::OPCode::POW;
+        case IR::Opcode::DP3: return ARBAssemblyDatabase::OPCode::DP3;
+        case IR::Opcode::LIT: return ARBAssemblyDatabase::OPCode::LIT;
+        case IR::Opcode::RSQ: return ARBAssemblyDatabase::OPCode::RSQ;
+        case IR::Opcode::MAX: return ARBAssemblyDatabase::OPCode::MAX;
+        case IR::Opcode::MIN: return ARBAssemblyDatabase::OPCode::MIN;
+        case IR::Opcode::ABS: return ARBAssemblyDatabase::OPCode::ABS;
+        case IR::Opcode::CMP: return ARBAssemblyDatabase::OPCode::CMP;
+        case IR::Opcode::MAD: return ARBAssemblyDatabase::OPCode::MAD;
+        case IR::Opcode::LRP: return ARBAssemblyDatabase::OPCode::LRP;
+        case IR::Opcode::SGE: return ARBAssemblyDatabase::OPCode::SGE;
+        case IR::Opcode::DP4: return ARBAssemblyDatabase::OPCode::DP4;
+        default:
+            assert(0);
+    }
+    return ARBAssemblyDatabase::OPCode::MOV;
+}
+
+/* Lower IR into ARB instructions on virtual TEMPs */
+void sendIRProgramToAssemblyDB(ARBAssemblyDatabase &assemblyDB, const IR::Program &program) {
+    const std::vector<IR::Instruction *> &instructions = program.getInstructions();
+
+    // components of each value read by each instruction, outputs are read after the last instruction
+    std::unordered_map<const IR::Value *, std::vector<std::pair<unsigned, IR::WriteMask>>> valueReads;
+    auto addValueRead = [&](const IR::Operand &operand, unsigned position, IR::WriteMask readMask) {
+        IR::WriteMask components = 0;
+        for(unsigned i = 0; i < 4; i++) {
+            if(readMask & (1u << i)) {
+                components |= (1u << operand.swizzle.getComponent(i));
+            }
+        }
+        // components beyond the size of the value are undefined
+        components &= IR::getFullWriteMask(operand.value->getNumberComponents());
+        valueReads[operand.value].emplace_back(position, components);
+    };
+
+    std::unordered_map<const IR::Value *, unsigned> useCounts;
+    for(unsigned i = 0; i < instructions.size(); i++) {
+        const IR::Instruction *ins = instructions[i];
+        for(const IR::Operand &src: ins->getSources()) {
+            addValueRead(src, i, IR::isScalarOpcode(ins->getOpcode()) ? 0x1 : ins->getSourceReadMask());
+        }
+        if(ins->isPredicated()) {
+            addValueRead(ins->getPredicate(), i, ins->getWriteMask());
+        }
+        if(ins->getMerge() != nullptr) {
+            addValueRead(IR::Operand(ins->getMerge()), i, ins->getMergeReadMask());
+        }
+        ins->forEachOperandValue([&](const IR::Value *value) {
+            useCounts[value]++;
+        });
+    }
+
+    // values narrower than a TEMP can be packed at a component offset of their register
+    std::unordered_map<const IR::Value *, unsigned> componentOffsets;
+
+    // a register can be updated in place if no later read of any value held by it needs the overwritten components
+    std::unordered_map<std::string, std::vector<const IR::Value *>> registerValues;
+    auto isOverwritable = [&](const std::string &regName, unsigned position, IR::WriteMask components) {
+        for(const IR::Value *value: registerValues[regName]) {
+            for(const auto &valueRead: valueReads[value]) {
+                if(valueRead.first > position && ((valueRead.second << componentOffsets[value]) & components)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    // values only read by a result register are written to the result register directly
+    std::unordered_map<const IR::Value *, std::string> regNames;
+    for(const IR::Output &output: program.getOutputs()) {
+        const IR::Value *value = output.value.value;
+        if(value->isInstruction() && useCounts[value] == 0 && output.value.swizzle.isIdentity() && !output.value.negate &&
+            value->getNumberComponents() == 4) {
+            regNames[value] = output.regName;
+        }
+        addValueRead(output.value, instructions.size(), 0xf);
+        useCounts[value]++;
+    }
+
+    std::unordered_map<std::string, unsigned> variableVersions;
+    auto getRegName = [&](const IR::Value *value) -> const std::string & {
+        auto fit = regNames.find(value);
+        if(fit != regNames.end()) {
+            return fit->second;
+        }
+
+        assert(value->isRegister());
+        regNames[value] = static_cast<const IR::Register *>(value)->getRegName();
+        return regNames[value];
+    };
+
+    // constants are placed in the constant pool, components are looked up by swizzle
+    std::unordered_map<const IR::Value *, std::pair<std::string, std::array<unsigned, 4>>> constantParams;
+    auto getConstantParam = [&](const IR::Constant *constant) -> const std::pair<std::string, std::array<unsigned, 4>> & {
+        auto fit = constantParams.find(constant);
+        if(fit != constantParams.end()) {
+            return fit->second;
+        }
+
+        const std::array<float, 4> &values = constant->getValues();
+        std::array<unsigned, 4> components = {{0, 0, 0, 0}};
+        const std::string &regName = assemblyDB.requestAutoParamRegister(
+            std::vector<float>(values.begin(), values.begin() + constant->getNumberComponents()), components);
+        constantParams[constant] = {regName, components};
+        return constantParams[constant];
+    };
+
+    // component i of the operand is read by component i + shift of the instruction
+    auto getOperandString = [&](const IR::Operand &operand, bool isScalarSource, IR::WriteMask readMask, unsigned shift) {
+        const IR::Value *value = operand.value;
+        std::string regName;
+        std::array<unsigned, 4> valueComponents = {{0, 1, 2, 3}};
+        if(value->isConstant()) {
+            const auto &constantParam = getConstantParam(static_cast<const IR::Constant *>(value));
+            regName = constantParam.first;
+            valueComponents = constantParam.second;
+        } else {
+            regName = getRegName(value);
+            for(unsigned &component: valueComponents) {
+                component = std::min(component + componentOffsets[value], 3u);
+            }
+        }
+
+        std::array<unsigned, 4> components = {{0, 0, 0, 0}};
+        unsigned componentMask = 0;
+        for(unsigned i = 0; i + shift < 4; i++) {
+            unsigned component = operand.swizzle.getComponent(i);
+            components[i + shift] = valueComponents[std::min(component, value->getNumberComponents() - 1)];
+            // components of the value beyond its size are undefined
+            if((readMask & (1u << i)) && component < value->getNumberComponents()) {
+                componentMask |= (1u << (i + shift));
+            }
+        }
+        // scalar opcodes read one component and ARB requires it replicated, constants included
+        assert(!isScalarSource || shift == 0);
+        IR::Swizzle swizzle = isScalarSource ? IR::Swizzle::replicate(components[0]) : IR::Swizzle::fromComponents(components, componentMask);
+        return (operand.negate ? "-" : "") + regName + swizzle.getString();
+    };
+    auto getMergeString = [&](const IR::Instruction *ins, unsigned shift) {
+        return getOperandString(IR::Operand(ins->getMerge()), false, ins->getMergeReadMask(), shift);
+    };
+
+    // first TEMP with enough free components, components are free once no later instruction reads them
+    std::vector<std::string> packableRegNames;
+    auto findPackedLocation = [&](const IR::Instruction *ins, unsigned position, std::string &regName, unsigned &offset) {
+        unsigned numberComponents = ins->getNumberComponents();
+        for(const std::string &packableRegName: packableRegNames) {
+            for(offset = 0; offset + numberComponents <= 4; offset++) {
+                if(isOverwritable(packableRegName, position, IR::getFullWriteMask(numberComponents) << offset)) {
+                    regName = packableRegName;
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    for(unsigned i = 0; i < instructions.size(); i++) {
+        const IR::Instruction *ins = instructions[i];
+
+        for(const std::string &annotation: ins->getAnnotations()) {
+            assemblyDB.insertInstructionComment(annotation);
+        }
+
+        IR::Value *merge = ins->getMerge();
+        bool needsMerge = (merge != nullptr) && (ins->isMasked() || ins->isPredicated());
+        IR::WriteMask writeMask = ins->getWriteMask();
+        bool isInPlace = needsMerge && merge->isInstruction() && regNames.count(ins) == 0 &&
+            componentOffsets[merge] + ins->getNumberComponents() <= 4 &&
+            isOverwritable(regNames[merge], i, writeMask << componentOffsets[merge]);
+
+        // destination register
+        std::string packedRegName;
+        unsigned packedOffset = 0;
+        if(isInPlace) {
+            regNames[ins] = regNames[merge];
+            componentOffsets[ins] = componentOffsets[merge];
+        } else if(regNames.count(ins) == 0 && !needsMerge && ins->getOpcode() != IR::Opcode::MOV &&
+            ins->getNumberComponents() < 4 && findPackedLocation(ins, i, packedRegName, packedOffset)) {
+            // a copy might become a no-op after allocation, and a merge would need a copy, so they are not packed
+            regNames[ins] = packedRegName;
+            componentOffsets[ins] = packedOffset;
+        } else if(regNames.count(ins) == 0) {
+            if(ins->getVariableName().empty()) {
+                regNames[ins] = assemblyDB.requestAutoTempRegister();
             } else {
-                assemblyDB.declareUserTempRegister(p.first);
+                unsigned version = variableVersions[ins->getVariableName()]++;
+                std::string regName = ins->getVariableName() + (version == 0 ? "" : "$" + std::to_string(version));
+                assemblyDB.declareUserTempRegister(regName);
+                regNames[ins] = regName;
+            }
+            packableRegNames.push_back(regNames[ins]);
+        }
+        std::string dst = regNames[ins];
+        unsigned shift = componentOffsets[ins];
+        registerValues[dst].push_back(ins);
+        // components beyond the size of the value are never read, so they are not written either
+        std::string mask = ((writeMask << shift) == 0xf) ? "" : "." + IR::getWriteMaskString(writeMask << shift);
+        std::string dstMasked = dst + mask;
+
+        // sources of component-wise instructions follow the destination components
+        unsigned sourceShift = IR::isComponentWiseOpcode(ins->getOpcode()) ? shift : 0;
+        std::vector<std::string> srcs;
+        for(const IR::Operand &src: ins->getSources()) {
+            srcs.push_back(getOperandString(src, IR::isScalarOpcode(ins->getOpcode()), ins->getSourceReadMask(), sourceShift));
+        }
+        srcs.resize(3);
+
+        if(!ins->isPredicated()) {
+            if(needsMerge && !isInPlace) {
+                // masked write keeps the other components of merge
+                assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, dst, getMergeString(ins, 0));
             }
+            assemblyDB.insertInstruction(getARBOpcode(ins->getOpcode()), dstMasked, srcs[0], srcs[1], srcs[2]);
+        } else {
+            std::string valueReg = srcs[0];
+            if(ins->getOpcode() != IR::Opcode::MOV) {
+                valueReg = assemblyDB.requestAutoTempRegister();
+                assemblyDB.insertInstruction(getARBOpcode(ins->getOpcode()), valueReg + mask, srcs[0], srcs[1], srcs[2]);
+            }
+            if(ins->isMasked() && !isInPlace) {
+                assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, dst, getMergeString(ins, 0));
+            }
+            assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::CMP,
+                dstMasked,
+                getOperandString(ins->getPredicate(), false, writeMask, shift),
+                getMergeString(ins, shift),  // if condition is false, no change
+                valueReg);
+        }
+    }
+
+    bool isFirstOutput = true;
+    for(const IR::Output &output: program.getOutputs()) {
+        auto fit = regNames.find(output.value.value);
+        if(fit != regNames.end() && fit->second == output.regName) {
+            continue;
+        }
+        if(isFirstOutput) {
+            assemblyDB.insertInstructionComment("");
+            assemblyDB.insertInstructionComment("Write result registers");
+            isFirstOutput = false;
+        }
+        assemblyDB.insertInstruction(ARBAssemblyDatabase::OPCode::MOV, output.regName,
+            getOperandString(output.value, output.value.value->getNumberComponents() == 1, 0xf, 0));
+    }
+}
+
+
+void sendInstructionToAssemblyDB(ARBAssemblyDatabase &assemblyDB, const DeclaredSymbolRegisterTable &declaredSymbolRegisterTable,
+    const UniformValueTable &uniformValueTable, std::vector<IR::HoistedExpression> *hoistedExpressions, AST::ASTNode *ast) {
+    // specialized uniforms are constants, which the constant folding propagates through expressions and if statements
+    std::map<std::string, std::array<float, 4>> registerValues;
+    for(const auto &uniformValue: uniformValueTable) {
+        registerValues[getPredefinedVariableRegisterName(uniformValue.first)] = uniformValue.second;
+    }
+
+    IR::Program program = createIRProgram(declaredSymbolRegisterTable, ast);
+    IR::bindRegisterValues(program, registerValues);
+    IR::propagateCopies(program);
+    IR::foldConstants(program);
+    IR::propagateCopies(program);
+    if(fastMath) {
+        IR::reassociate(program);
+        IR::propagateCopies(program);
+        IR::foldConstants(program);
+        IR::propagateCopies(program);
+    }
+    if(hoistedExpressions != nullptr) {
+        // before strength reduction, so the host evaluates a POW of uniforms directly
+        std::unordered_set<std::string> uniformRegNames;
+        for(const std::string &uniformVariableName: l_uniformVariableNames) {
+            uniformRegNames.insert(getPredefinedVariableRegisterName(uniformVariableName));
+        }
+        *hoistedExpressions = IR::hoistUniformExpressions(program, uniformRegNames);
+    }
+    IR::reduceStrength(program);
+    IR::mergeSelects(program);
+    IR::numberValues(program);
+    IR::eliminateDeadCode(program);
+    IR::vectorizeScalars(program);
+    IR::propagateCopies(program);
+    IR::eliminateDeadCode(program);
+    IR::selectInstructions(program);
+    IR::eliminateDeadCode(program);
+
+    // printf("\n");
+    // printf("IR Program\n");
+    // program.dump();
+    sendIRProgramToAssemblyDB(assemblyDB, program);
+}
+
+
+void DeclaredSymbolRegisterTable::sendToAssemblyDB(ARBAssemblyDatabase &assemblyDB) const {      
+    // in the order of declaration, so the output does not depend on hashing
+    for(const AST::DeclarationNode *decl: m_declarationOrder) {
+        if(decl->isOrdinaryType() && !decl->isConst()) {
+            assemblyDB.declareUserTempRegister(getRegisterName(decl));
         }
     }
 }
@@ -1066,20 +1790,212 @@ void DeclaredSymbolRegisterTable::sendToAssemblyDB(ARBAssemblyDatabase &assembly
 } /* END NAMESPACE */
 
 
-int genCode(node *ast) {
+bool parseUniformValue(const std::string &assignment, UniformValueTable &uniformValueTable) {
+    std::string::size_type equalPos = assignment.find('=');
+    if(equalPos == std::string::npos) {
+        return false;
+    }
+
+    std::stringstream nameStream(assignment.substr(0, equalPos));
+    std::string name;
+    nameStream >> name;
+    if(COGEN::l_uniformVariableNames.count(name) == 0) {
+        return false;
+    }
+
+    // exactly four components, separated by commas
+    std::stringstream valueStream(assignment.substr(equalPos + 1));
+    std::array<float, 4> values = {{0.0, 0.0, 0.0, 0.0}};
+    for(unsigned i = 0; i < 4; i++) {
+        char separator = ',';
+        if((i > 0 && !(valueStream >> separator)) || separator != ',' || !(valueStream >> values[i])) {
+            return false;
+        }
+    }
+    std::string rest;
+    if(valueStream >> rest) {
+        return false;
+    }
+
+    uniformValueTable[name] = values;
+    return true;
+}
+
+bool readUniformValueFile(const char *fileName, UniformValueTable &uniformValueTable) {
+    FILE *file = fopen(fileName, "r");
+    if(file == nullptr) {
+        return false;
+    }
+
+    // the table is only updated if the whole file is well-formed
+    UniformValueTable fileValueTable;
+    bool isWellFormed = true;
+    char line[MAX_TEXT];
+    while(isWellFormed && fgets(line, sizeof(line), file) != nullptr) {
+        std::string assignment(line);
+        std::string::size_type begin = assignment.find_first_not_of(" \t\r\n");
+        if(begin == std::string::npos || assignment[begin] == '#') {
+            continue;
+        }
+        isWellFormed = parseUniformValue(assignment, fileValueTable);
+    }
+    fclose(file);
+
+    if(isWellFormed) {
+        for(const auto &uniformValue: fileValueTable) {
+            uniformValueTable[uniformValue.first] = uniformValue.second;
+        }
+    }
+    return isWellFormed;
+}
+
+/* JSON object from each program.local[] register to its type and the expression the host evaluates per draw */
+static std::string generatePrecomputeTable(const std::vector<IR::HoistedExpression> &hoistedExpressions) {
+    std::string precomputeTable = "{";
+    for(unsigned i = 0; i < hoistedExpressions.size(); i++) {
+        const IR::HoistedExpression &hoistedExpression = hoistedExpressions[i];
+        precomputeTable += (i == 0 ? "\n" : ",\n");
+        precomputeTable += "    \"" + hoistedExpression.regName + "\": {\"type\": \"" +
+            AST::getTypeString(hoistedExpression.dataType) + "\", \"expression\": \"" + hoistedExpression.expression + "\"}";
+    }
+    precomputeTable += "\n}";
+    return precomputeTable;
+}
+
+/* Uniform-only computations are hoisted into program.local[] registers, described in precomputeTable, unless it is nullptr */
+static std::string generateProgram(const COGEN::DeclaredSymbolRegisterTable &declaredSymbolRegisterTable,
+    const UniformValueTable &uniformValueTable, node *ast, std::string *precomputeTable) {
     COGEN::ARBAssemblyDatabase assemblyDB;
-    COGEN::DeclaredSymbolRegisterTable declaredSymbolRegisterTable =
-        COGEN::createDeclaredSymbolRegisterTable(static_cast<AST::ASTNode *>(ast));
+    assemblyDB.setPrecisionHintFastest(fastMath);
 
+    std::vector<IR::HoistedExpression> hoistedExpressions;
     declaredSymbolRegisterTable.sendToAssemblyDB(assemblyDB);
-    COGEN::sendInstructionToAssemblyDB(assemblyDB, declaredSymbolRegisterTable, ast);
+    COGEN::sendInstructionToAssemblyDB(assemblyDB, declaredSymbolRegisterTable, uniformValueTable,
+        (precomputeTable != nullptr) ? &hoistedExpressions : nullptr, ast);
+    assemblyDB.allocateTempRegisters();
+    assemblyDB.removeUnusedDeclarations();
+
+    if(precomputeTable != nullptr) {
+        *precomputeTable = generatePrecomputeTable(hoistedExpressions);
+    }
 
     // printf("\n");
     // printf("ARB Assembly Database\n");
     // assemblyDB.dump();
+    return assemblyDB.generateProgram();
+}
+
+bool readVariantFile(const char *fileName, std::vector<UniformValueTable> &variants) {
+    FILE *file = fopen(fileName, "r");
+    if(file == nullptr) {
+        return false;
+    }
+
+    // one variant per line, as assignments separated by ';'
+    std::vector<UniformValueTable> fileVariants;
+    bool isWellFormed = true;
+    char line[MAX_TEXT];
+    while(isWellFormed && fgets(line, sizeof(line), file) != nullptr) {
+        std::string assignments(line);
+        std::string::size_type begin = assignments.find_first_not_of(" \t\r\n");
+        if(begin == std::string::npos || assignments[begin] == '#') {
+            continue;
+        }
+
+        UniformValueTable variant;
+        std::stringstream assignmentStream(assignments);
+        std::string assignment;
+        while(isWellFormed && std::getline(assignmentStream, assignment, ';')) {
+            if(assignment.find_first_not_of(" \t\r\n") != std::string::npos) {
+                isWellFormed = parseUniformValue(assignment, variant);
+            }
+        }
+        fileVariants.push_back(variant);
+    }
+    fclose(file);
+
+    if(isWellFormed && !fileVariants.empty()) {
+        variants.insert(variants.end(), fileVariants.begin(), fileVariants.end());
+        return true;
+    }
+    return false;
+}
+
+int genCode(node *ast, const UniformValueTable &uniformValueTable) {
+    COGEN::DeclaredSymbolRegisterTable declaredSymbolRegisterTable =
+        COGEN::createDeclaredSymbolRegisterTable(static_cast<AST::ASTNode *>(ast));
+
+    std::string precomputeTable;
+    std::string program = generateProgram(declaredSymbolRegisterTable, uniformValueTable, ast,
+        (precomputeFile != nullptr) ? &precomputeTable : nullptr);
+    if(errorOccurred) {
+        // a loop could not be unrolled
+        fprintf(outputFile, "Failed to compile\n");
+        return 1;
+    }
     if(dumpInstructions) {
-        assemblyDB.output(dumpFile);
+        fwrite(program.data(), 1, program.size(), dumpFile);
+    }
+    if(precomputeFile != nullptr) {
+        fprintf(precomputeFile, "%s\n", precomputeTable.c_str());
     }
     
     return 0;
-}
\ No newline at end of file
+}
+
+int genVariantCode(node *ast, const UniformValueTable &uniformValueTable, const std::vector<UniformValueTable> &variants) {
+    // the analyzed AST and its declarations are shared, only the IR onwards is rebuilt per variant
+    COGEN::DeclaredSymbolRegisterTable declaredSymbolRegisterTable =
+        COGEN::createDeclaredSymbolRegisterTable(static_cast<AST::ASTNode *>(ast));
+
+    std::vector<std::string> programs;
+    std::vector<std::string> precomputeTables;
+    std::map<std::string, unsigned> firstVariantOfProgram;
+    std::vector<std::pair<unsigned, unsigned>> identicalVariants;
+    for(const UniformValueTable &variant: variants) {
+        // values of the variant override the common ones
+        UniformValueTable variantValueTable = variant;
+        variantValueTable.insert(uniformValueTable.begin(), uniformValueTable.end());
+
+        std::string precomputeTable;
+        programs.push_back(generateProgram(declaredSymbolRegisterTable, variantValueTable, ast,
+            (precomputeFile != nullptr) ? &precomputeTable : nullptr));
+        precomputeTables.push_back(precomputeTable);
+
+        // identical only if the host computes the same program.local[] registers as well
+        unsigned variantIndex = programs.size();
+        auto insertResult = firstVariantOfProgram.emplace(programs.back() + precomputeTable, variantIndex);
+        if(!insertResult.second) {
+            identicalVariants.emplace_back(variantIndex, insertResult.first->second);
+        }
+    }
+    if(errorOccurred) {
+        // a loop could not be unrolled
+        fprintf(outputFile, "Failed to compile\n");
+        return 1;
+    }
+
+    if(dumpInstructions) {
+        for(unsigned i = 0; i < programs.size(); i++) {
+            fprintf(dumpFile, "# Variant %u\n", i + 1);
+            fwrite(programs[i].data(), 1, programs[i].size(), dumpFile);
+            fprintf(dumpFile, "\n");
+        }
+
+        fprintf(dumpFile, "# Identical Variants\n");
+        for(const auto &identicalVariant: identicalVariants) {
+            fprintf(dumpFile, "# Variant %u : Variant %u\n", identicalVariant.first, identicalVariant.second);
+        }
+    }
+
+    // one precompute table per variant, in the order of the variants
+    if(precomputeFile != nullptr) {
+        fprintf(precomputeFile, "[");
+        for(unsigned i = 0; i < precomputeTables.size(); i++) {
+            fprintf(precomputeFile, "%s\n%s", (i == 0 ? "" : ","), precomputeTables[i].c_str());
+        }
+        fprintf(precomputeFile, "\n]\n");
+    }
+
+    return 0;
+}
@@ -3,6 +3,26 @@
 
 #include "ast.h"
 
-int genCode(node *ast);
+#include <string>
+#include <array>
+#include <map>
+#include <vector>
 
-#endif
\ No newline at end of file
+/* Values of uniform variables known at compile time (env1, gl_Light_Half, ...), by variable name */
+using UniformValueTable = std::map<std::string, std::array<float, 4>>;
+
+/* Adds "name = x, y, z, w" to the table, false if malformed or name is not a uniform */
+bool parseUniformValue(const std::string &assignment, UniformValueTable &uniformValueTable);
+/* Adds one assignment per line, skipping empty lines and # comments, false if any line is malformed */
+bool readUniformValueFile(const char *fileName, UniformValueTable &uniformValueTable);
+
+/* Adds one variant per line, as assignments separated by ';' (a line of only ';' is unspecialized),
+   false if any line is malformed or there is no variant */
+bool readVariantFile(const char *fileName, std::vector<UniformValueTable> &variants);
+
+/* Uniforms in the table are specialized to their values */
+int genCode(node *ast, const UniformValueTable &uniformValueTable = UniformValueTable());
+/* One program per variant from the same analyzed AST, followed by the list of variants identical to an earlier one */
+int genVariantCode(node *ast, const UniformValueTable &uniformValueTable, const std::vector<UniformValueTable> &variants);
+
+#endif
@@ -35,6 +35,7 @@ extern FILE * errorFile;
 extern FILE * dumpFile;
 extern FILE * traceFile;
 extern FILE * runInputFile;
+extern FILE * precomputeFile;
 
 extern int errorOccurred;
 extern int suppressExecution;
@@ -47,6 +48,8 @@ extern int dumpSource;
 extern int dumpAST;
 extern int dumpSymbols;
 extern int dumpInstructions;
+extern int fastMath;
+extern int unrollBudget;
 
 
 
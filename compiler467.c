@@ -27,6 +27,9 @@
  **********************************************************************/
 #include "common.h"
 
+#include <string.h>
+#include <stdlib.h>
+
 /* Phases 3,4: Uncomment following includes as needed */
 #include "ast.h"
 #include "semantic.h"
@@ -43,10 +46,18 @@
 #define DEFAULT_TRACE_FILE     stdout
 #define DEFAULT_RUN_INPUT_FILE stdin
 
+/* Instructions a while loop may unroll into, before optimization */
+#define DEFAULT_UNROLL_BUDGET  4096
+
 void  getOpts   (int numargs, char **argstr);
 FILE *fileOpen  (const char *fileName, const char *fileMode, FILE *defaultFile);
 void  sourceDump(void);
 
+/* Uniforms specialized with -u, passed to the code generator */
+static UniformValueTable uniformValueTable;
+/* Specialization sets read with -V, one program is generated for each */
+static std::vector<UniformValueTable> variants;
+
 /* Phase 1: Scanner Interface. For phase 2 and after these declarations
  * are removed */
 /*
@@ -104,8 +115,13 @@ int main (int argc, char *argv[]) {
 /* TODO: call your code generation routine here */
   if (errorOccurred)
     fprintf(outputFile,"Failed to compile\n");
-  else 
-    genCode(ast);
+  else {
+    semantic_simplify(ast);
+    if (variants.empty())
+      genCode(ast, uniformValueTable);
+    else
+      genVariantCode(ast, uniformValueTable, variants);
+  }
 
 /***********************************************************************
  * Post Compilation Cleanup
@@ -127,6 +143,8 @@ int main (int argc, char *argv[]) {
     fclose (outputFile);
   if (runInputFile != DEFAULT_RUN_INPUT_FILE)
     fclose (runInputFile);
+  if (precomputeFile != NULL)
+    fclose (precomputeFile);
 
   return 0;
 }
@@ -151,6 +169,7 @@ void getOpts (int numargs, char **argstr) {
   dumpFile          = DEFAULT_DUMP_FILE;
   traceFile         = DEFAULT_TRACE_FILE;
   runInputFile      = DEFAULT_RUN_INPUT_FILE;
+  precomputeFile    = NULL;
 
   /* Initialize control flags */
   suppressExecution = FALSE;
@@ -164,6 +183,9 @@ void getOpts (int numargs, char **argstr) {
   dumpSymbols       = FALSE;
   dumpInstructions  = FALSE;
 
+  fastMath          = FALSE;
+  unrollBudget      = DEFAULT_UNROLL_BUDGET;
+
   /* Process command line input */
   for (i=1; i<numargs; i++) {
     optarg = argstr[i];
@@ -232,9 +254,43 @@ void getOpts (int numargs, char **argstr) {
           } else
             runInputFile = fileOpen (&optarg[2], "r", DEFAULT_RUN_INPUT_FILE);
           break;
+        case 'P': /* Hoist uniform-only expressions, host precompute table file */
+          if (optarg[2] == 0) {
+            i += 1;
+            precomputeFile = fileOpen (argstr[i], "w", NULL);
+          } else
+            precomputeFile = fileOpen (&optarg[2], "w", NULL);
+          break;
         case 'X': /* supress execution flag */
           suppressExecution = TRUE;
           break;
+        case 'u': /* Uniform specialization -u name=x,y,z,w or -u file */
+          if (optarg[2] == 0)
+            subarg = argstr[++i];
+          if (subarg == NULL)
+            fprintf(errorFile, "Missing uniform value after -u\n");
+          else if (strchr(subarg, '=') != NULL) {
+            if (!parseUniformValue(subarg, uniformValueTable))
+              fprintf(errorFile, "Invalid uniform value %s ignored\n", subarg);
+          } else if (!readUniformValueFile(subarg, uniformValueTable))
+            fprintf(errorFile, "Invalid uniform value file %s ignored\n", subarg);
+          break;
+        case 'V': /* Variants -V file, one specialization set per line */
+          if (optarg[2] == 0)
+            subarg = argstr[++i];
+          if (subarg == NULL)
+            fprintf(errorFile, "Missing variant file after -V\n");
+          else if (!readVariantFile(subarg, variants))
+            fprintf(errorFile, "Invalid variant file %s ignored\n", subarg);
+          break;
+        case 'f': /* Code generation flags -ffast-math -funroll-budget=N */
+          if (strcmp(subarg, "fast-math") == 0)
+            fastMath = TRUE;
+          else if (strncmp(subarg, "unroll-budget=", 14) == 0 && atoi(subarg + 14) > 0)
+            unrollBudget = atoi(subarg + 14);
+          else
+            fprintf(errorFile, "Invalid flag %s ignored\n", optarg);
+          break;
         default: /* Anything else */
           fprintf(stderr,"Unknown option character %c (ignored)\n", optch);
           break;
@@ -44,6 +44,9 @@ int dumpInstructions;
  * **NOTE** If you need to add global variables for phases 1 to 4, add
  * them below this comment.
  **********************************************************************/
+int fastMath;       /* -ffast-math: reassociate floating point expressions, hint fastest precision */
+int unrollBudget;   /* -funroll-budget=N: instructions one while loop may unroll into before it is unbounded */
+FILE * precomputeFile; /* -P: hoist uniform-only expressions, describe them for the host here (NULL if off) */
 
 
 
@@ -0,0 +1,1744 @@
+#include "ir.h"
+
+#include "semantic.h"
+#include "common.h"
+#include "parser.tab.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <sstream>
+#include <iomanip>
+
+namespace IR{ /* START NAMESPACE */
+
+std::string getOpcodeString(Opcode opCode) {
+    switch(opCode) {
+        case Opcode::MOV: return "MOV";
+        case Opcode::ADD: return "ADD";
+        case Opcode::SUB: return "SUB";
+        case Opcode::MUL: return "MUL";
+        case Opcode::RCP: return "RCP";
+        case Opcode::POW: return "POW";
+        case Opcode::DP3: return "DP3";
+        case Opcode::LIT: return "LIT";
+        case Opcode::RSQ: return "RSQ";
+        case Opcode::MAX: return "MAX";
+        case Opcode::MIN: return "MIN";
+        case Opcode::ABS: return "ABS";
+        case Opcode::CMP: return "CMP";
+        case Opcode::MAD: return "MAD";
+        case Opcode::LRP: return "LRP";
+        case Opcode::SGE: return "SGE";
+        case Opcode::DP4: return "DP4";
+        default:
+            assert(0);
+    }
+    return "";
+}
+
+unsigned getOpcodeNumberSources(Opcode opCode) {
+    switch(opCode) {
+        case Opcode::MOV:
+        case Opcode::RCP:
+        case Opcode::LIT:
+        case Opcode::RSQ:
+        case Opcode::ABS:
+            return 1;
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+        case Opcode::POW:
+        case Opcode::DP3:
+        case Opcode::MAX:
+        case Opcode::MIN:
+        case Opcode::SGE:
+        case Opcode::DP4:
+            return 2;
+        case Opcode::CMP:
+        case Opcode::MAD:
+        case Opcode::LRP:
+            return 3;
+        default:
+            assert(0);
+    }
+    return 0;
+}
+
+bool isScalarOpcode(Opcode opCode) {
+    switch(opCode) {
+        case Opcode::RCP:
+        case Opcode::POW:
+        case Opcode::RSQ:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isComponentWiseOpcode(Opcode opCode) {
+    switch(opCode) {
+        case Opcode::RCP:
+        case Opcode::POW:
+        case Opcode::RSQ:
+        case Opcode::DP3:
+        case Opcode::DP4:
+        case Opcode::LIT:
+            return false;
+        default:
+            return true;
+    }
+}
+
+WriteMask getFullWriteMask(unsigned numberComponents) {
+    assert(numberComponents >= 1 && numberComponents <= 4);
+    return (1u << numberComponents) - 1;
+}
+
+std::string getWriteMaskString(WriteMask writeMask) {
+    static const char *componentNames = "xyzw";
+    std::string maskString;
+    for(unsigned i = 0; i < 4; i++) {
+        if(writeMask & (1u << i)) {
+            maskString += componentNames[i];
+        }
+    }
+    return maskString;
+}
+
+
+Swizzle Swizzle::fromComponents(const std::array<unsigned, 4> &components, unsigned componentMask) {
+    if(componentMask == 0) {
+        return Swizzle();
+    }
+
+    bool isIdentity = true;
+    bool isReplicate = true;
+    unsigned firstComponent = 4;
+    for(unsigned i = 0; i < 4; i++) {
+        if(componentMask & (1u << i)) {
+            firstComponent = (firstComponent == 4) ? components[i] : firstComponent;
+            isIdentity = isIdentity && (components[i] == i);
+            isReplicate = isReplicate && (components[i] == firstComponent);
+        }
+    }
+    if(isIdentity) {
+        return Swizzle();
+    }
+    if(isReplicate) {
+        return replicate(firstComponent);
+    }
+
+    // repeat the previous component
+    std::array<unsigned, 4> swizzleComponents = components;
+    unsigned lastComponent = firstComponent;
+    for(unsigned i = 0; i < 4; i++) {
+        if(componentMask & (1u << i)) {
+            lastComponent = components[i];
+        }
+        swizzleComponents[i] = lastComponent;
+    }
+    return Swizzle(swizzleComponents[0], swizzleComponents[1], swizzleComponents[2], swizzleComponents[3]);
+}
+
+bool Swizzle::isIdentity() const {
+    return *this == Swizzle();
+}
+
+bool Swizzle::isReplicate() const {
+    return *this == replicate(m_components[0]);
+}
+
+std::string Swizzle::getString() const {
+    static const char *componentNames = "xyzw";
+    for(unsigned component: m_components) {
+        assert(component < 4);
+    }
+    if(isIdentity()) {
+        return "";
+    }
+    if(isReplicate()) {
+        return std::string(".") + componentNames[m_components[0]];
+    }
+
+    std::string swizzleString = ".";
+    for(unsigned component: m_components) {
+        swizzleString += componentNames[component];
+    }
+    return swizzleString;
+}
+
+
+unsigned Value::getNumberComponents() const {
+    return SEMA::getDataTypeOrder(m_dataType);
+}
+
+std::string Operand::getString() const {
+    assert(isValid());
+    return (negate ? "-" : "") + value->getName() + swizzle.getString();
+}
+
+
+Instruction::Instruction(unsigned id, int dataType, Opcode opCode, const std::vector<Operand> &sources):
+    Value(Kind::Instruction, id, dataType), m_opCode(opCode), m_sources(sources) {
+    assert(sources.size() == getOpcodeNumberSources(opCode));
+    m_writeMask = getFullWriteMask(getNumberComponents());
+}
+
+WriteMask Instruction::getSourceReadMask() const {
+    switch(m_opCode) {
+        case Opcode::RCP:
+        case Opcode::POW:
+        case Opcode::RSQ:
+            return 0x1;
+        case Opcode::DP3:
+            return 0x7;
+        case Opcode::DP4:
+            return 0xf;
+        case Opcode::LIT:
+            return 0xb;
+        default:
+            return m_writeMask;
+    }
+}
+
+WriteMask Instruction::getMergeReadMask() const {
+    WriteMask fullWriteMask = getFullWriteMask(getNumberComponents());
+    return isPredicated() ? fullWriteMask : (fullWriteMask & ~m_writeMask);
+}
+
+std::string Instruction::generateCode() const {
+    std::stringstream ss;
+    ss << std::left << std::setw(6) << getName() << " = ";
+
+    std::string opString = getOpcodeString(m_opCode);
+    if(isMasked()) {
+        opString += "." + getWriteMaskString(m_writeMask);
+    }
+    ss << std::left << std::setw(10) << opString;
+    ss << std::left << std::setw(7) << AST::getTypeString(getDataType());
+
+    for(unsigned i = 0; i < m_sources.size(); i++) {
+        ss << (i == 0 ? "" : ", ") << m_sources[i].getString();
+    }
+
+    if(isPredicated()) {
+        ss << " if " << m_predicate.getString();
+    }
+    if(m_merge != nullptr) {
+        ss << " else " << m_merge->getName();
+    }
+    if(!m_variableName.empty()) {
+        ss << " ; " << m_variableName;
+    }
+    return ss.str();
+}
+
+
+Program::Program() {
+    m_trueConstant = createConstant(BVEC4_T, {{1.0, 1.0, 1.0, 1.0}});
+    m_falseConstant = createConstant(BVEC4_T, {{-1.0, -1.0, -1.0, -1.0}});
+    m_zeroConstant = createConstant(VEC4_T, {{0.0, 0.0, 0.0, 0.0}});
+}
+
+Constant *Program::createConstant(int dataType, const std::array<float, 4> &values) {
+    Constant *constant = new Constant(m_values.size(), dataType, values);
+    m_values.emplace_back(constant);
+    return constant;
+}
+
+Register *Program::createRegister(int dataType, const std::string &regName) {
+    for(const auto &value: m_values) {
+        if(value->isRegister() && static_cast<Register *>(value.get())->getRegName() == regName) {
+            assert(value->getDataType() == dataType);
+            return static_cast<Register *>(value.get());
+        }
+    }
+
+    Register *reg = new Register(m_values.size(), dataType, regName);
+    m_values.emplace_back(reg);
+    return reg;
+}
+
+Instruction *Program::createInstruction(int dataType, Opcode opCode, const std::vector<Operand> &sources) {
+    Instruction *instruction = new Instruction(m_values.size(), dataType, opCode, sources);
+    m_values.emplace_back(instruction);
+    m_instructions.push_back(instruction);
+    return instruction;
+}
+
+Instruction *Program::insertInstruction(const Instruction *before, int dataType, Opcode opCode, const std::vector<Operand> &sources) {
+    auto position = std::find(m_instructions.begin(), m_instructions.end(), before);
+    assert(position != m_instructions.end());
+
+    Instruction *instruction = new Instruction(m_values.size(), dataType, opCode, sources);
+    m_values.emplace_back(instruction);
+    m_instructions.insert(position, instruction);
+    return instruction;
+}
+
+void Program::setOutput(const std::string &regName, const Operand &value) {
+    for(Output &output: m_outputs) {
+        if(output.regName == regName) {
+            output.value = value;
+            return;
+        }
+    }
+    m_outputs.push_back({regName, value});
+}
+
+void Program::removeInstructions(const std::unordered_set<const Instruction *> &instructions) {
+    std::vector<Instruction *> remainingInstructions;
+    std::vector<std::string> pendingAnnotations;
+
+    for(Instruction *instruction: m_instructions) {
+        if(instructions.count(instruction)) {
+            // the latest annotated instruction begins the statement the next instruction belongs to
+            if(!instruction->getAnnotations().empty()) {
+                pendingAnnotations = instruction->getAnnotations();
+            }
+            continue;
+        }
+
+        if(!pendingAnnotations.empty() && instruction->getAnnotations().empty()) {
+            instruction->setAnnotations(std::move(pendingAnnotations));
+        }
+        pendingAnnotations.clear();
+        remainingInstructions.push_back(instruction);
+    }
+
+    m_instructions = std::move(remainingInstructions);
+}
+
+std::vector<std::string> Program::generateCode() const {
+    std::vector<std::string> irCode;
+
+    for(const auto &value: m_values) {
+        std::stringstream ss;
+        if(value->isConstant()) {
+            const Constant *constant = static_cast<const Constant *>(value.get());
+            ss << std::left << std::setw(6) << constant->getName() << " = ";
+            ss << std::left << std::setw(10) << "CONST";
+            ss << std::left << std::setw(7) << AST::getTypeString(constant->getDataType());
+            ss << "{";
+            for(unsigned i = 0; i < constant->getNumberComponents(); i++) {
+                ss << (i == 0 ? "" : ",") << constant->getValueAt(i);
+            }
+            ss << "}";
+        } else if(value->isRegister()) {
+            const Register *reg = static_cast<const Register *>(value.get());
+            ss << std::left << std::setw(6) << reg->getName() << " = ";
+            ss << std::left << std::setw(10) << "REG";
+            ss << std::left << std::setw(7) << AST::getTypeString(reg->getDataType());
+            ss << reg->getRegName();
+        } else {
+            continue;
+        }
+        irCode.push_back(ss.str());
+    }
+
+    for(const Instruction *instruction: m_instructions) {
+        for(const std::string &annotation: instruction->getAnnotations()) {
+            if(!annotation.empty()) {
+                irCode.push_back("# " + annotation);
+            }
+        }
+        irCode.push_back(instruction->generateCode());
+    }
+
+    for(const Output &output: m_outputs) {
+        irCode.push_back(output.regName + " = " + output.value.getString());
+    }
+
+    return irCode;
+}
+
+void Program::dump() const {
+    std::vector<std::string> irCode = generateCode();
+
+    for(unsigned i = 0; i < irCode.size(); i++) {
+        printf("%-12u %s\n", i + 1, irCode[i].c_str());
+    }
+}
+
+/* Every operand is defined before use, and every instruction is well typed */
+void Program::verify() const {
+    std::unordered_set<const Value *> definedValues;
+    for(const auto &value: m_values) {
+        if(!value->isInstruction()) {
+            definedValues.insert(value.get());
+        }
+    }
+
+    for(const Instruction *instruction: m_instructions) {
+        assert(definedValues.count(instruction) == 0);
+        assert(instruction->getSources().size() == getOpcodeNumberSources(instruction->getOpcode()));
+        assert((instruction->getWriteMask() & ~getFullWriteMask(instruction->getNumberComponents())) == 0);
+        assert(!instruction->isPredicated() || instruction->getPredicate().value->getNumberComponents() >= 1);
+        instruction->forEachOperandValue([&](const Value *value) {
+            assert(definedValues.count(value) == 1);
+            (void)value;
+        });
+        definedValues.insert(instruction);
+    }
+
+    for(const Output &output: m_outputs) {
+        assert(definedValues.count(output.value.value) == 1);
+    }
+}
+
+
+/**********************************************************************************
+ * Dead Code Elimination
+ **********************************************************************************/
+void eliminateDeadCode(Program &program) {
+    std::unordered_set<const Value *> liveValues;
+    for(const Output &output: program.getOutputs()) {
+        liveValues.insert(output.value.value);
+    }
+
+    /* Straight-line SSA, a single backward walk finds every live instruction */
+    std::unordered_set<const Instruction *> deadInstructions;
+    const std::vector<Instruction *> &instructions = program.getInstructions();
+    for(auto iter = instructions.rbegin(); iter != instructions.rend(); ++iter) {
+        const Instruction *instruction = *iter;
+        if(liveValues.count(instruction) == 0) {
+            deadInstructions.insert(instruction);
+            continue;
+        }
+
+        instruction->forEachOperandValue([&](const Value *value) {
+            liveValues.insert(value);
+        });
+    }
+
+    if(!deadInstructions.empty()) {
+        program.removeInstructions(deadInstructions);
+    }
+}
+
+
+
+/**********************************************************************************
+ * Copy Propagation
+ **********************************************************************************/
+struct CopySource {
+    Value *value;
+    unsigned component;
+    bool negate;
+};
+
+/* Follows unpredicated MOVs back to where the component is computed, false if the component is undefined */
+static bool resolveCopySource(Value *value, unsigned component, CopySource &copySource) {
+    bool negate = false;
+    while(value->isInstruction()) {
+        const Instruction *instruction = static_cast<const Instruction *>(value);
+        if(instruction->getOpcode() != Opcode::MOV || instruction->isPredicated()) {
+            break;
+        }
+
+        if(instruction->getWriteMask() & (1u << component)) {
+            const Operand &src = instruction->getSourceAt(0);
+            value = src.value;
+            component = src.swizzle.getComponent(component);
+            negate = (negate != src.negate);
+        } else if(instruction->getMerge() != nullptr) {
+            value = instruction->getMerge();
+        } else {
+            return false;
+        }
+    }
+
+    copySource = {value, component, negate};
+    return true;
+}
+
+/* Rewrites the operand to read from the copy source directly, if every read component agrees on one */
+static bool propagateOperand(Operand &operand, WriteMask readMask) {
+    Value *value = nullptr;
+    bool negate = false;
+    std::array<unsigned, 4> components = {{0, 1, 2, 3}};
+    WriteMask definedMask = 0;
+
+    for(unsigned i = 0; i < 4; i++) {
+        CopySource copySource;
+        if(!(readMask & (1u << i)) || !resolveCopySource(operand.value, operand.swizzle.getComponent(i), copySource)) {
+            continue;
+        }
+        if(value == nullptr) {
+            value = copySource.value;
+            negate = copySource.negate;
+        } else if(value != copySource.value || negate != copySource.negate) {
+            return false;
+        }
+        components[i] = copySource.component;
+        definedMask |= (1u << i);
+    }
+    if(value == nullptr) {
+        return false;
+    }
+
+    Operand propagatedOperand(value, Swizzle::fromComponents(components, definedMask), operand.negate != negate);
+    if(propagatedOperand.value == operand.value && propagatedOperand.swizzle == operand.swizzle &&
+        propagatedOperand.negate == operand.negate) {
+        return false;
+    }
+    operand = propagatedOperand;
+    return true;
+}
+
+/* Merge carries no swizzle or negation, it can only be replaced by a plain copy source */
+static void propagateMerge(Instruction *instruction) {
+    Operand merge(instruction->getMerge());
+    if(merge.isValid() && propagateOperand(merge, instruction->getMergeReadMask()) &&
+        merge.swizzle.isIdentity() && !merge.negate) {
+        instruction->setMerge(merge.value);
+    }
+}
+
+void propagateCopies(Program &program) {
+    for(Instruction *instruction: program.getInstructions()) {
+        WriteMask sourceReadMask = instruction->getSourceReadMask();
+        for(Operand &src: instruction->getSources()) {
+            propagateOperand(src, sourceReadMask);
+        }
+        if(instruction->isPredicated()) {
+            propagateOperand(instruction->getPredicate(), instruction->getWriteMask());
+        }
+        propagateMerge(instruction);
+
+        // the copied value keeps the name of the variable, if it has none
+        if(instruction->getOpcode() == Opcode::MOV && !instruction->isPredicated() && !instruction->isMasked() &&
+            !instruction->getVariableName().empty()) {
+            const Operand &src = instruction->getSourceAt(0);
+            if(src.value->isInstruction() && src.swizzle.isIdentity() && !src.negate &&
+                static_cast<Instruction *>(src.value)->getVariableName().empty()) {
+                static_cast<Instruction *>(src.value)->setVariableName(instruction->getVariableName());
+            }
+        }
+    }
+
+    for(Output &output: program.getOutputs()) {
+        propagateOperand(output.value, getFullWriteMask(output.value.value->getNumberComponents()));
+    }
+}
+
+
+
+/**********************************************************************************
+ * Register Binding
+ **********************************************************************************/
+void bindRegisterValues(Program &program, const std::map<std::string, std::array<float, 4>> &registerValues) {
+    if(registerValues.empty()) {
+        return;
+    }
+
+    // every read of a register is its own Value, which is replaced by a constant of the same type
+    auto bind = [&](Value *value) -> Value * {
+        if(!value->isRegister()) {
+            return value;
+        }
+        auto fit = registerValues.find(static_cast<const Register *>(value)->getRegName());
+        return (fit == registerValues.end()) ? value : program.createConstant(value->getDataType(), fit->second);
+    };
+
+    for(Instruction *instruction: program.getInstructions()) {
+        for(Operand &src: instruction->getSources()) {
+            src.value = bind(src.value);
+        }
+        if(instruction->isPredicated()) {
+            instruction->getPredicate().value = bind(instruction->getPredicate().value);
+        }
+        if(instruction->getMerge() != nullptr) {
+            instruction->setMerge(bind(instruction->getMerge()));
+        }
+    }
+
+    for(Output &output: program.getOutputs()) {
+        output.value.value = bind(output.value.value);
+    }
+}
+
+
+/**********************************************************************************
+ * Constant Folding
+ **********************************************************************************/
+/* Lane i of a constant operand */
+static float getConstantOperandValue(const Operand &operand, unsigned i) {
+    float value = static_cast<const Constant *>(operand.value)->getValueAt(operand.swizzle.getComponent(i));
+    return operand.negate ? -value : value;
+}
+
+/* Result of the opcode on known sources, src(s, i) is lane i of source s, false if not representable */
+template <typename SourceFunc>
+static bool evaluateOpcodeOn(Opcode opCode, SourceFunc src, std::array<float, 4> &values) {
+    for(unsigned i = 0; i < 4; i++) {
+        switch(opCode) {
+            case Opcode::MOV: values[i] = src(0, i); break;
+            case Opcode::ADD: values[i] = src(0, i) + src(1, i); break;
+            case Opcode::SUB: values[i] = src(0, i) - src(1, i); break;
+            case Opcode::MUL: values[i] = src(0, i) * src(1, i); break;
+            case Opcode::RCP: values[i] = 1.0f / src(0, 0); break;
+            case Opcode::POW: values[i] = std::pow(src(0, 0), src(1, 0)); break;
+            case Opcode::DP3: values[i] = src(0, 0) * src(1, 0) + src(0, 1) * src(1, 1) + src(0, 2) * src(1, 2); break;
+            case Opcode::RSQ: values[i] = 1.0f / std::sqrt(std::fabs(src(0, 0))); break;
+            case Opcode::MAX: values[i] = std::max(src(0, i), src(1, i)); break;
+            case Opcode::MIN: values[i] = std::min(src(0, i), src(1, i)); break;
+            case Opcode::ABS: values[i] = std::fabs(src(0, i)); break;
+            case Opcode::CMP: values[i] = (src(0, i) < 0.0f) ? src(1, i) : src(2, i); break;
+            case Opcode::MAD: values[i] = src(0, i) * src(1, i) + src(2, i); break;
+            case Opcode::LRP: values[i] = src(0, i) * src(1, i) + (1.0f - src(0, i)) * src(2, i); break;
+            case Opcode::SGE: values[i] = (src(0, i) >= src(1, i)) ? 1.0f : 0.0f; break;
+            case Opcode::DP4: values[i] = src(0, 0) * src(1, 0) + src(0, 1) * src(1, 1) + src(0, 2) * src(1, 2) + src(0, 3) * src(1, 3); break;
+            case Opcode::LIT: {
+                float x = std::max(src(0, 0), 0.0f);
+                float y = std::max(src(0, 1), 0.0f);
+                float w = std::min(std::max(src(0, 3), -128.0f), 128.0f);
+                values = {{1.0f, x, (x > 0.0f) ? std::pow(y, w) : 0.0f, 1.0f}};
+                return std::isfinite(values[2]);
+            }
+            default:
+                assert(0);
+        }
+        if(!std::isfinite(values[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Result of the opcode on constant sources, false if not representable */
+static bool evaluateOpcode(Opcode opCode, const std::vector<Operand> &sources, std::array<float, 4> &values) {
+    return evaluateOpcodeOn(opCode, [&](unsigned s, unsigned i) { return getConstantOperandValue(sources[s], i); }, values);
+}
+
+/* Lanes of a value computed only from constants and known values, memoized in knownValues, unknown values in unknownValues */
+static bool evaluateValue(const Value *value, std::unordered_map<const Value *, std::array<float, 4>> &knownValues,
+    std::unordered_set<const Value *> &unknownValues, std::array<float, 4> &values);
+
+static bool evaluateOperandValues(const Operand &operand, std::unordered_map<const Value *, std::array<float, 4>> &knownValues,
+    std::unordered_set<const Value *> &unknownValues, std::array<float, 4> &values) {
+    std::array<float, 4> valueValues;
+    if(!evaluateValue(operand.value, knownValues, unknownValues, valueValues)) {
+        return false;
+    }
+    for(unsigned i = 0; i < 4; i++) {
+        values[i] = operand.negate ? -valueValues[operand.swizzle.getComponent(i)] : valueValues[operand.swizzle.getComponent(i)];
+    }
+    return true;
+}
+
+static bool evaluateInstruction(const Instruction *instruction, std::unordered_map<const Value *, std::array<float, 4>> &knownValues,
+    std::unordered_set<const Value *> &unknownValues, std::array<float, 4> &values) {
+    unsigned numberComponents = instruction->getNumberComponents();
+    WriteMask fullWriteMask = getFullWriteMask(numberComponents);
+
+    // components taken from the operation, the others keep the merge
+    WriteMask operationMask = instruction->getWriteMask();
+    if(instruction->isPredicated()) {
+        std::array<float, 4> predicateValues;
+        if(!evaluateOperandValues(instruction->getPredicate(), knownValues, unknownValues, predicateValues)) {
+            return false;
+        }
+        for(unsigned i = 0; i < numberComponents; i++) {
+            if(predicateValues[i] < 0.0f) {
+                operationMask &= ~(1u << i);
+            }
+        }
+    }
+
+    std::array<float, 4> operationValues = {{0.0, 0.0, 0.0, 0.0}};
+    if(operationMask != 0) {
+        std::vector<std::array<float, 4>> sourceValues(instruction->getSources().size());
+        std::vector<bool> isKnownSource(instruction->getSources().size());
+        bool isKnownOperation = true;
+        for(unsigned s = 0; s < sourceValues.size(); s++) {
+            isKnownSource[s] = evaluateOperandValues(instruction->getSourceAt(s), knownValues, unknownValues, sourceValues[s]);
+            isKnownOperation = isKnownOperation && isKnownSource[s];
+        }
+
+        if(isKnownOperation) {
+            auto src = [&](unsigned s, unsigned i) { return sourceValues[s][i]; };
+            if(!evaluateOpcodeOn(instruction->getOpcode(), src, operationValues)) {
+                return false;
+            }
+        } else if(SEMA::getDataTypeCategory(instruction->getDataType()) == SEMA::DataTypeCategory::Boolean &&
+            (instruction->getOpcode() == Opcode::MIN || instruction->getOpcode() == Opcode::MAX)) {
+            // booleans are true or false, so false && b and true || b are known without b
+            float dominant = (instruction->getOpcode() == Opcode::MIN) ? -1.0f : 1.0f;
+            bool isDominated = false;
+            for(unsigned s = 0; s < sourceValues.size(); s++) {
+                bool isDominant = isKnownSource[s];
+                for(unsigned i = 0; i < numberComponents; i++) {
+                    isDominant = isDominant && (sourceValues[s][i] == dominant);
+                }
+                isDominated = isDominated || isDominant;
+            }
+            if(!isDominated) {
+                return false;
+            }
+            operationValues = {{dominant, dominant, dominant, dominant}};
+        } else {
+            return false;
+        }
+    }
+
+    std::array<float, 4> mergeValues = {{0.0, 0.0, 0.0, 0.0}};
+    if((fullWriteMask & ~operationMask) != 0) {
+        if(instruction->getMerge() == nullptr ||
+            !evaluateValue(instruction->getMerge(), knownValues, unknownValues, mergeValues)) {
+            return false;
+        }
+    }
+
+    for(unsigned i = 0; i < 4; i++) {
+        values[i] = (i >= numberComponents) ? 0.0f : ((operationMask & (1u << i)) ? operationValues[i] : mergeValues[i]);
+    }
+    return true;
+}
+
+static bool evaluateValue(const Value *value, std::unordered_map<const Value *, std::array<float, 4>> &knownValues,
+    std::unordered_set<const Value *> &unknownValues, std::array<float, 4> &values) {
+    auto fit = knownValues.find(value);
+    if(fit != knownValues.end()) {
+        values = fit->second;
+        return true;
+    }
+    if(value->isConstant()) {
+        values = static_cast<const Constant *>(value)->getValues();
+        return true;
+    }
+    if(value->isRegister() || unknownValues.count(value) == 1) {
+        return false;
+    }
+
+    if(!evaluateInstruction(static_cast<const Instruction *>(value), knownValues, unknownValues, values)) {
+        unknownValues.insert(value);
+        return false;
+    }
+    knownValues[value] = values;
+    return true;
+}
+
+bool evaluateOperand(const Operand &operand, const std::unordered_map<const Value *, std::array<float, 4>> &assumedValues,
+    std::array<float, 4> &values) {
+    std::unordered_map<const Value *, std::array<float, 4>> knownValues = assumedValues;
+    std::unordered_set<const Value *> unknownValues;
+    return evaluateOperandValues(operand, knownValues, unknownValues, values);
+}
+
+/*
+    Fragment programs are straight-line, so a single forward walk visits every definition before its uses.
+    Predicates known at compile time select the operation or the merge for each component, so
+    statically dead branches leave only their merges behind, and always taken branches lose the predicate.
+*/
+void foldConstants(Program &program) {
+    std::unordered_map<const Value *, Value *> replacements;
+    auto replace = [&](Value *value) -> Value * {
+        auto fit = replacements.find(value);
+        return (fit == replacements.end()) ? value : fit->second;
+    };
+
+    std::unordered_set<const Instruction *> foldedInstructions;
+    for(Instruction *instruction: program.getInstructions()) {
+        for(Operand &src: instruction->getSources()) {
+            src.value = replace(src.value);
+        }
+        if(instruction->isPredicated()) {
+            instruction->getPredicate().value = replace(instruction->getPredicate().value);
+        }
+        if(instruction->getMerge() != nullptr) {
+            instruction->setMerge(replace(instruction->getMerge()));
+        }
+
+        unsigned numberComponents = instruction->getNumberComponents();
+        WriteMask fullWriteMask = getFullWriteMask(numberComponents);
+        WriteMask writeMask = instruction->getWriteMask();
+
+        // components taken from the operation, the others keep the merge
+        WriteMask operationMask = writeMask;
+        if(instruction->isPredicated() && instruction->getPredicate().value->isConstant()) {
+            for(unsigned i = 0; i < numberComponents; i++) {
+                if(getConstantOperandValue(instruction->getPredicate(), i) < 0.0f) {
+                    operationMask &= ~(1u << i);
+                }
+            }
+
+            if(operationMask == 0) {
+                assert(instruction->getMerge() != nullptr);
+                replacements[instruction] = instruction->getMerge();
+                foldedInstructions.insert(instruction);
+                continue;
+            }
+            if(operationMask == writeMask) {
+                Value *merge = instruction->isMasked() ? instruction->getMerge() : nullptr;
+                instruction->setPredicate(Operand(), merge);
+            }
+        }
+
+        // a CMP on a known condition selects one of the sources
+        if(instruction->getOpcode() == Opcode::CMP && instruction->getSourceAt(0).value->isConstant()) {
+            WriteMask negativeMask = 0;
+            for(unsigned i = 0; i < numberComponents; i++) {
+                if(getConstantOperandValue(instruction->getSourceAt(0), i) < 0.0f) {
+                    negativeMask |= (1u << i);
+                }
+            }
+            if((negativeMask & writeMask) == writeMask) {
+                instruction->setOpcode(Opcode::MOV, {instruction->getSourceAt(1)});
+            } else if((negativeMask & writeMask) == 0) {
+                instruction->setOpcode(Opcode::MOV, {instruction->getSourceAt(2)});
+            }
+        }
+
+        // identities with one known operand, as the AST simplifier does for literals: x+0, 0+x, x*1, 1*x, true&&b, false||b
+        if(instruction->getSources().size() == 2 && instruction->getOpcode() != Opcode::MOV) {
+            static const std::vector<std::pair<Opcode, float>> identities = {
+                {Opcode::ADD, 0.0f}, {Opcode::MUL, 1.0f}, {Opcode::MIN, 1.0f}, {Opcode::MAX, -1.0f}
+            };
+            bool isBoolean = SEMA::getDataTypeCategory(instruction->getDataType()) == SEMA::DataTypeCategory::Boolean;
+            for(const auto &identity: identities) {
+                if(instruction->getOpcode() != identity.first ||
+                    ((identity.first == Opcode::MIN || identity.first == Opcode::MAX) && !isBoolean)) {
+                    continue;
+                }
+                for(unsigned s = 0; s < 2 && instruction->getOpcode() == identity.first; s++) {
+                    const Operand &src = instruction->getSourceAt(s);
+                    bool isIdentity = src.value->isConstant();
+                    for(unsigned i = 0; i < numberComponents && isIdentity; i++) {
+                        isIdentity = ((writeMask & (1u << i)) == 0) || getConstantOperandValue(src, i) == identity.second;
+                    }
+                    if(isIdentity) {
+                        instruction->setOpcode(Opcode::MOV, {instruction->getSourceAt(1 - s)});
+                    }
+                }
+            }
+        }
+
+        bool isConstantOperation = !instruction->isPredicated() || instruction->getPredicate().value->isConstant();
+        for(const Operand &src: instruction->getSources()) {
+            isConstantOperation = isConstantOperation && src.value->isConstant();
+        }
+        if(!isConstantOperation) {
+            continue;
+        }
+
+        std::array<float, 4> values = {{0.0, 0.0, 0.0, 0.0}};
+        if(!evaluateOpcode(instruction->getOpcode(), instruction->getSources(), values)) {
+            continue;
+        }
+
+        // every component not from the operation must be a known merge
+        WriteMask mergeMask = fullWriteMask & ~operationMask;
+        if(mergeMask != 0) {
+            Value *merge = instruction->getMerge();
+            if(merge != nullptr && !merge->isConstant()) {
+                continue;
+            }
+            for(unsigned i = 0; i < numberComponents; i++) {
+                if(mergeMask & (1u << i)) {
+                    values[i] = (merge != nullptr) ? static_cast<const Constant *>(merge)->getValueAt(i) : 0.0f;
+                }
+            }
+        }
+        for(unsigned i = numberComponents; i < 4; i++) {
+            values[i] = 0.0;
+        }
+
+        replacements[instruction] = program.createConstant(instruction->getDataType(), values);
+        foldedInstructions.insert(instruction);
+    }
+
+    for(Output &output: program.getOutputs()) {
+        output.value.value = replace(output.value.value);
+    }
+
+    if(!foldedInstructions.empty()) {
+        program.removeInstructions(foldedInstructions);
+    }
+}
+
+
+/**********************************************************************************
+ * Strength Reduction
+ **********************************************************************************/
+/*
+    POW with a known exponent becomes at most two cheaper instructions:
+    x^0 = 1, x^1 = x, x^2 = x*x, x^3 = x*x*x, x^4 = (x*x)*(x*x), x^-1 = 1/x, x^-2 = 1/(x*x),
+    x^0.5 = 1/rsq(x) and x^-0.5 = rsq(x).
+    The last instruction replaces the POW, keeping its predicate and write mask.
+*/
+void reduceStrength(Program &program) {
+    std::vector<Instruction *> instructions = program.getInstructions();
+    for(Instruction *instruction: instructions) {
+        if(instruction->getOpcode() != Opcode::POW || !instruction->getSourceAt(1).value->isConstant()) {
+            continue;
+        }
+
+        // POW reads the first component and replicates the result, so do the replacements
+        const Operand &src = instruction->getSourceAt(0);
+        Operand base(src.value, Swizzle::replicate(src.swizzle.getComponent(0)), src.negate);
+        float exponent = getConstantOperandValue(instruction->getSourceAt(1), 0);
+        auto insert = [&](Opcode opCode, const std::vector<Operand> &sources) {
+            Instruction *inserted = program.insertInstruction(instruction, instruction->getDataType(), opCode, sources);
+            // the statement begins at the first instruction
+            inserted->setAnnotations(std::vector<std::string>(instruction->getAnnotations()));
+            instruction->setAnnotations({});
+            return Operand(inserted);
+        };
+
+        if(exponent == 0.0f) {
+            Operand one(program.createConstant(instruction->getDataType(), {{1.0, 0.0, 0.0, 0.0}}), Swizzle::replicate(0));
+            instruction->setOpcode(Opcode::MOV, {one});
+        } else if(exponent == 1.0f) {
+            instruction->setOpcode(Opcode::MOV, {base});
+        } else if(exponent == 2.0f) {
+            instruction->setOpcode(Opcode::MUL, {base, base});
+        } else if(exponent == 3.0f) {
+            instruction->setOpcode(Opcode::MUL, {insert(Opcode::MUL, {base, base}), base});
+        } else if(exponent == 4.0f) {
+            Operand square = insert(Opcode::MUL, {base, base});
+            instruction->setOpcode(Opcode::MUL, {square, square});
+        } else if(exponent == -1.0f) {
+            instruction->setOpcode(Opcode::RCP, {base});
+        } else if(exponent == -2.0f) {
+            instruction->setOpcode(Opcode::RCP, {insert(Opcode::MUL, {base, base})});
+        } else if(exponent == 0.5f) {
+            instruction->setOpcode(Opcode::RCP, {insert(Opcode::RSQ, {base})});
+        } else if(exponent == -0.5f) {
+            instruction->setOpcode(Opcode::RSQ, {base});
+        }
+    }
+}
+
+
+/**********************************************************************************
+ * Select Merging
+ **********************************************************************************/
+/* Operand reading the components of inner selected by the swizzle of outer */
+static Operand composeOperand(const Operand &inner, const Operand &outer) {
+    Swizzle swizzle(inner.swizzle.getComponent(outer.swizzle.getComponent(0)),
+                    inner.swizzle.getComponent(outer.swizzle.getComponent(1)),
+                    inner.swizzle.getComponent(outer.swizzle.getComponent(2)),
+                    inner.swizzle.getComponent(outer.swizzle.getComponent(3)));
+    return Operand(inner.value, swizzle, inner.negate != outer.negate);
+}
+
+/* Conditions of nested if statements are CMP outer, outer, owned */
+static bool isNestedCondition(const Operand &operand, Operand &outer, Operand &owned) {
+    if(!operand.value->isInstruction() || operand.negate) {
+        return false;
+    }
+    const Instruction *condition = static_cast<const Instruction *>(operand.value);
+    if(condition->getOpcode() != Opcode::CMP || condition->isPredicated() || condition->isMasked() ||
+        condition->getSourceAt(0) != condition->getSourceAt(1)) {
+        return false;
+    }
+    outer = composeOperand(condition->getSourceAt(0), operand);
+    owned = composeOperand(condition->getSourceAt(2), operand);
+    return true;
+}
+
+/*
+    The then branch assigns  %then = MOV t if cond else %prev,
+    the else branch assigns  %else = MOV e if !cond else %then.
+    Conditions are either 1.0 or -1.0, so %else = CMP cond, e, t (keeping %prev outside of the write mask).
+    In nested if statements, cond is CMP outer, outer, owned and !cond is CMP outer, outer, -owned
+    (or -cond, which is the same where outer holds), so %else = CMP owned, e, t if outer else %prev.
+*/
+void mergeSelects(Program &program) {
+    for(Instruction *elseInstruction: program.getInstructions()) {
+        Value *merge = elseInstruction->getMerge();
+        if(elseInstruction->getOpcode() != Opcode::MOV || !elseInstruction->isPredicated() ||
+            merge == nullptr || !merge->isInstruction()) {
+            continue;
+        }
+
+        const Instruction *thenInstruction = static_cast<const Instruction *>(merge);
+        if(thenInstruction->getOpcode() != Opcode::MOV || !thenInstruction->isPredicated() ||
+            thenInstruction->getWriteMask() != elseInstruction->getWriteMask()) {
+            continue;
+        }
+
+        const Operand &thenCondition = thenInstruction->getPredicate();
+        const Operand &elseCondition = elseInstruction->getPredicate();
+        const Operand &thenValue = thenInstruction->getSourceAt(0);
+        const Operand &elseValue = elseInstruction->getSourceAt(0);
+        Value *prevValue = thenInstruction->getMerge();
+
+        Operand thenOuter, thenOwned, elseOuter, elseOwned;
+        if(elseCondition == Operand(thenCondition.value, thenCondition.swizzle, !thenCondition.negate)) {
+            elseInstruction->setOpcode(Opcode::CMP, {thenCondition, elseValue, thenValue});
+            elseInstruction->setPredicate(Operand(), elseInstruction->isMasked() ? prevValue : nullptr);
+        } else if(isNestedCondition(thenCondition, thenOuter, thenOwned) &&
+            isNestedCondition(elseCondition, elseOuter, elseOwned) &&
+            thenOuter == elseOuter && (elseOwned == Operand(thenOwned.value, thenOwned.swizzle, !thenOwned.negate) ||
+                                       elseOwned == Operand(thenCondition.value, thenCondition.swizzle, !thenCondition.negate))) {
+            elseInstruction->setOpcode(Opcode::CMP, {thenOwned, elseValue, thenValue});
+            elseInstruction->setPredicate(thenOuter, prevValue);
+        }
+    }
+}
+
+
+/**********************************************************************************
+ * Reassociation
+ **********************************************************************************/
+/* Splits an ADD or SUB with exactly one constant source into variable + constant, the SUB negates its second source */
+static bool splitConstantAddend(const Instruction *instruction, Operand &variable, Operand &constant) {
+    if(instruction->getOpcode() != Opcode::ADD && instruction->getOpcode() != Opcode::SUB) {
+        return false;
+    }
+    Operand lhs = instruction->getSourceAt(0);
+    Operand rhs = instruction->getSourceAt(1);
+    if(instruction->getOpcode() == Opcode::SUB) {
+        rhs.negate = !rhs.negate;
+    }
+
+    if(lhs.value->isConstant() == rhs.value->isConstant()) {
+        return false;
+    }
+    variable = lhs.value->isConstant() ? rhs : lhs;
+    constant = lhs.value->isConstant() ? lhs : rhs;
+    return true;
+}
+
+/* Splits a MUL with exactly one constant source into variable * constant */
+static bool splitConstantFactor(const Instruction *instruction, Operand &variable, Operand &constant) {
+    if(instruction->getOpcode() != Opcode::MUL) {
+        return false;
+    }
+    const Operand &lhs = instruction->getSourceAt(0);
+    const Operand &rhs = instruction->getSourceAt(1);
+
+    if(lhs.value->isConstant() == rhs.value->isConstant()) {
+        return false;
+    }
+    variable = lhs.value->isConstant() ? rhs : lhs;
+    constant = lhs.value->isConstant() ? lhs : rhs;
+    return true;
+}
+
+/* The instruction computing every component of the operand on its own, nullptr otherwise */
+static const Instruction *getPlainInstruction(const Operand &operand) {
+    if(!operand.value->isInstruction()) {
+        return nullptr;
+    }
+    const Instruction *instruction = static_cast<const Instruction *>(operand.value);
+    if(instruction->isPredicated() || instruction->isMasked()) {
+        return nullptr;
+    }
+    return instruction;
+}
+
+/*
+    Only valid without strict IEEE semantics, the rounding of intermediate results changes
+    and infinities or NaNs may be lost:
+    (y + c1) + c2 = y + (c1 + c2), (y * c1) * c2 = y * (c1 * c2), (y + c1) * c2 = y * c2 + c1 * c2
+    (which instruction selection turns into a MAD), x * 0 = 0 and x - x = 0.
+    A single forward walk collapses whole chains, since inner instructions are rewritten first.
+*/
+void reassociate(Program &program) {
+    auto isZero = [](const Operand &operand, unsigned numberComponents) {
+        if(!operand.value->isConstant()) {
+            return false;
+        }
+        for(unsigned i = 0; i < numberComponents; i++) {
+            if(getConstantOperandValue(operand, i) != 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto createConstant = [&program](int dataType, const Operand &lhs, const Operand &rhs, Opcode opCode) -> Operand {
+        std::array<float, 4> values = {{0.0, 0.0, 0.0, 0.0}};
+        if(!evaluateOpcode(opCode, {lhs, rhs}, values)) {
+            return Operand();
+        }
+        for(unsigned i = static_cast<unsigned>(SEMA::getDataTypeOrder(dataType)); i < 4; i++) {
+            values[i] = 0.0;
+        }
+        return Operand(program.createConstant(dataType, values));
+    };
+
+    std::vector<Instruction *> instructions = program.getInstructions();
+    for(Instruction *instruction: instructions) {
+        int dataType = instruction->getDataType();
+        unsigned numberComponents = instruction->getNumberComponents();
+        Operand variable, constant, innerVariable, innerConstant;
+
+        if((instruction->getOpcode() == Opcode::MUL &&
+                (isZero(instruction->getSourceAt(0), numberComponents) || isZero(instruction->getSourceAt(1), numberComponents))) ||
+            (instruction->getOpcode() == Opcode::SUB && instruction->getSourceAt(0) == instruction->getSourceAt(1))) {
+            instruction->setOpcode(Opcode::MOV, {Operand(program.createConstant(dataType, {{0.0, 0.0, 0.0, 0.0}}))});
+        } else if(splitConstantAddend(instruction, variable, constant)) {
+            const Instruction *inner = getPlainInstruction(variable);
+            if(inner == nullptr || !splitConstantAddend(inner, innerVariable, innerConstant)) {
+                continue;
+            }
+
+            // the negation of the variable applies to both terms of the inner sum
+            Operand sum = createConstant(dataType, composeOperand(innerConstant, variable), constant, Opcode::ADD);
+            if(sum.isValid()) {
+                instruction->setOpcode(Opcode::ADD, {composeOperand(innerVariable, variable), sum});
+            }
+        } else if(splitConstantFactor(instruction, variable, constant)) {
+            const Instruction *inner = getPlainInstruction(variable);
+            if(inner == nullptr) {
+                continue;
+            }
+
+            if(splitConstantFactor(inner, innerVariable, innerConstant)) {
+                // the negation of the variable applies to one factor of the inner product only
+                Operand product = createConstant(dataType,
+                    composeOperand(innerConstant, Operand(variable.value, variable.swizzle)), constant, Opcode::MUL);
+                if(product.isValid()) {
+                    instruction->setOpcode(Opcode::MUL, {composeOperand(innerVariable, variable), product});
+                }
+            } else if(splitConstantAddend(inner, innerVariable, innerConstant)) {
+                Operand product = createConstant(dataType, composeOperand(innerConstant, variable), constant, Opcode::MUL);
+                if(product.isValid()) {
+                    Instruction *scaled = program.insertInstruction(instruction, dataType, Opcode::MUL,
+                        {composeOperand(innerVariable, variable), constant});
+                    // the statement begins at the first instruction
+                    scaled->setAnnotations(std::vector<std::string>(instruction->getAnnotations()));
+                    instruction->setAnnotations({});
+                    instruction->setOpcode(Opcode::ADD, {Operand(scaled), product});
+                }
+            }
+        }
+    }
+}
+
+
+/**********************************************************************************
+ * Global Value Numbering
+ **********************************************************************************/
+static bool isCommutativeOpcode(Opcode opCode) {
+    switch(opCode) {
+        case Opcode::ADD:
+        case Opcode::MUL:
+        case Opcode::DP3:
+        case Opcode::DP4:
+        case Opcode::MAX:
+        case Opcode::MIN:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Constants with the same type and bits are equal values, everything else is identified by the SSA name */
+static std::string getValueNumberString(const Value *value) {
+    if(value->isConstant()) {
+        const Constant *constant = static_cast<const Constant *>(value);
+        std::stringstream ss;
+        ss << constant->getDataType() << "{" << std::hex;
+        for(unsigned i = 0; i < constant->getNumberComponents(); i++) {
+            float component = constant->getValueAt(i);
+            uint32_t bits;
+            memcpy(&bits, &component, sizeof(bits));
+            ss << (i == 0 ? "" : ",") << bits;
+        }
+        ss << "}";
+        return ss.str();
+    }
+    return value->getName();
+}
+
+static std::string getValueNumberString(const Operand &operand) {
+    return (operand.negate ? "-" : "") + getValueNumberString(operand.value) + operand.swizzle.getString();
+}
+
+/* Two instructions with the same key compute the same value */
+static std::string getValueNumberKey(const Instruction *instruction) {
+    std::vector<std::string> sources;
+    for(const Operand &src: instruction->getSources()) {
+        sources.push_back(getValueNumberString(src));
+    }
+    if(isCommutativeOpcode(instruction->getOpcode())) {
+        std::sort(sources.begin(), sources.end());
+    }
+
+    std::string key = getOpcodeString(instruction->getOpcode()) + "." + getWriteMaskString(instruction->getWriteMask()) +
+        " " + std::to_string(instruction->getDataType());
+    for(const std::string &src: sources) {
+        key += " " + src;
+    }
+    if(instruction->isPredicated()) {
+        key += " if " + getValueNumberString(instruction->getPredicate());
+    }
+    if(instruction->getMerge() != nullptr) {
+        key += " else " + getValueNumberString(instruction->getMerge());
+    }
+    return key;
+}
+
+void numberValues(Program &program) {
+    std::unordered_map<std::string, Instruction *> valueNumbers;
+    std::unordered_map<const Value *, Instruction *> replacements;
+    auto replace = [&](Value *value) -> Value * {
+        auto fit = replacements.find(value);
+        return (fit == replacements.end()) ? value : fit->second;
+    };
+
+    std::unordered_set<const Instruction *> redundantInstructions;
+    for(Instruction *instruction: program.getInstructions()) {
+        for(Operand &src: instruction->getSources()) {
+            src.value = replace(src.value);
+        }
+        if(instruction->isPredicated()) {
+            instruction->getPredicate().value = replace(instruction->getPredicate().value);
+        }
+        if(instruction->getMerge() != nullptr) {
+            instruction->setMerge(replace(instruction->getMerge()));
+        }
+
+        auto result = valueNumbers.emplace(getValueNumberKey(instruction), instruction);
+        if(!result.second) {
+            replacements[instruction] = result.first->second;
+            redundantInstructions.insert(instruction);
+        }
+    }
+
+    for(Output &output: program.getOutputs()) {
+        output.value.value = replace(output.value.value);
+    }
+
+    if(!redundantInstructions.empty()) {
+        program.removeInstructions(redundantInstructions);
+    }
+}
+
+
+/**********************************************************************************
+ * Instruction Selection
+ **********************************************************************************/
+/* Where a value is read: a source index of the instruction, its predicate, its merge or a result register */
+struct Use {
+    enum class Kind {
+        Source,
+        Predicate,
+        Merge,
+        Output
+    };
+
+    Kind kind;
+    Instruction *instruction;
+    unsigned source;
+};
+
+static std::unordered_map<const Value *, std::vector<Use>> getUses(Program &program) {
+    std::unordered_map<const Value *, std::vector<Use>> uses;
+    for(Instruction *instruction: program.getInstructions()) {
+        for(unsigned i = 0; i < instruction->getSources().size(); i++) {
+            uses[instruction->getSourceAt(i).value].push_back({Use::Kind::Source, instruction, i});
+        }
+        if(instruction->isPredicated()) {
+            uses[instruction->getPredicate().value].push_back({Use::Kind::Predicate, instruction, 0});
+        }
+        if(instruction->getMerge() != nullptr) {
+            uses[instruction->getMerge()].push_back({Use::Kind::Merge, instruction, 0});
+        }
+    }
+    for(const Output &output: program.getOutputs()) {
+        uses[output.value.value].push_back({Use::Kind::Output, nullptr, 0});
+    }
+    return uses;
+}
+
+/* The operand is the only use of a plain computation with the opcode, which can be folded into its user */
+static Instruction *matchSubtree(const Operand &operand, Opcode opCode,
+    const std::unordered_map<const Value *, std::vector<Use>> &uses) {
+    if(!operand.value->isInstruction()) {
+        return nullptr;
+    }
+    Instruction *subtree = static_cast<Instruction *>(operand.value);
+    if(subtree->getOpcode() != opCode || subtree->isPredicated() || subtree->isMasked() ||
+        uses.at(subtree).size() != 1) {
+        return nullptr;
+    }
+    return subtree;
+}
+
+/* 1 or -1 if every component of the operand is the constant true or false, 0 otherwise */
+static int getBooleanConstant(const Operand &operand, unsigned numberComponents) {
+    if(!operand.value->isConstant()) {
+        return 0;
+    }
+    float value = getConstantOperandValue(operand, 0);
+    for(unsigned i = 0; i < numberComponents; i++) {
+        if(getConstantOperandValue(operand, i) != value) {
+            return 0;
+        }
+    }
+    return (value == 1.0f) ? 1 : ((value == -1.0f) ? -1 : 0);
+}
+
+/* ADD a*b, c and SUB a*b, c become MAD a, b, c (negating a or c), costing one instruction instead of two */
+static bool selectMultiplyAdd(Instruction *instruction, const std::unordered_map<const Value *, std::vector<Use>> &uses) {
+    Opcode opCode = instruction->getOpcode();
+    if(opCode != Opcode::ADD && opCode != Opcode::SUB) {
+        return false;
+    }
+
+    for(unsigned i = 0; i < 2; i++) {
+        const Operand &product = instruction->getSourceAt(i);
+        const Instruction *multiply = matchSubtree(product, Opcode::MUL, uses);
+        if(multiply == nullptr) {
+            continue;
+        }
+
+        Operand a = composeOperand(multiply->getSourceAt(0), product);
+        Operand b = composeOperand(multiply->getSourceAt(1), Operand(product.value, product.swizzle));
+        Operand c = instruction->getSourceAt(1 - i);
+        if(opCode == Opcode::SUB) {
+            if(i == 0) {
+                c.negate = !c.negate;
+            } else {
+                a.negate = !a.negate;
+            }
+        }
+        instruction->setOpcode(Opcode::MAD, {a, b, c});
+        return true;
+    }
+    return false;
+}
+
+/* MAD t, x-y, y is LRP t, x, y */
+static bool selectInterpolation(Instruction *instruction, const std::unordered_map<const Value *, std::vector<Use>> &uses) {
+    if(instruction->getOpcode() != Opcode::MAD) {
+        return false;
+    }
+
+    const Operand &addend = instruction->getSourceAt(2);
+    for(unsigned i = 0; i < 2; i++) {
+        const Operand &factor = instruction->getSourceAt(1 - i);
+        const Operand &difference = instruction->getSourceAt(i);
+        const Instruction *subtract = matchSubtree(difference, Opcode::SUB, uses);
+        if(subtract == nullptr) {
+            continue;
+        }
+
+        // -(x-y) is y-x
+        Operand minuend = composeOperand(subtract->getSourceAt(0), Operand(difference.value, difference.swizzle));
+        Operand subtrahend = composeOperand(subtract->getSourceAt(1), Operand(difference.value, difference.swizzle));
+        if(difference.negate) {
+            std::swap(minuend, subtrahend);
+        }
+        if(subtrahend == addend) {
+            instruction->setOpcode(Opcode::LRP, {factor, minuend, addend});
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+    A comparison is condition = CMP d, true, false (or CMP d, false, true), so only the sign of d matters
+    where the condition is a predicate or the first source of a CMP. Those uses read d directly:
+    a CMP swaps its other sources, a predicate on d < 0 reads -SGE instead of the SUB computing d.
+*/
+static void selectCondition(Instruction *condition, const std::unordered_map<const Value *, std::vector<Use>> &uses) {
+    if(condition->getOpcode() != Opcode::CMP || condition->isPredicated() || condition->isMasked()) {
+        return;
+    }
+    unsigned numberComponents = condition->getNumberComponents();
+    int trueIfNegative = getBooleanConstant(condition->getSourceAt(1), numberComponents);
+    if(trueIfNegative == 0 || getBooleanConstant(condition->getSourceAt(2), numberComponents) != -trueIfNegative) {
+        return;
+    }
+
+    auto fit = uses.find(condition);
+    if(fit == uses.end()) {
+        return;
+    }
+
+    bool hasNegativePredicate = false;
+    bool hasOtherUse = false;
+    for(const Use &use: fit->second) {
+        if(use.kind == Use::Kind::Predicate) {
+            // applied where the condition is not negative, when d is negative
+            bool isNegativePredicate = ((trueIfNegative == 1) != use.instruction->getPredicate().negate);
+            hasNegativePredicate = hasNegativePredicate || isNegativePredicate;
+            hasOtherUse = hasOtherUse || !isNegativePredicate;
+        } else if(use.kind == Use::Kind::Source && use.source == 0 && use.instruction->getOpcode() == Opcode::CMP) {
+            hasOtherUse = true;
+        } else {
+            return;
+        }
+    }
+
+    // d < 0 needs an SGE, which only pays off if it replaces the SUB
+    const Operand &sign = condition->getSourceAt(0);
+    Instruction *subtract = nullptr;
+    if(hasNegativePredicate) {
+        subtract = matchSubtree(sign, Opcode::SUB, uses);
+        if(hasOtherUse || sign.negate || subtract == nullptr) {
+            return;
+        }
+        subtract->setOpcode(Opcode::SGE, subtract->getSources());
+    }
+
+    for(const Use &use: fit->second) {
+        Instruction *user = use.instruction;
+        if(use.kind == Use::Kind::Predicate) {
+            Operand &predicate = user->getPredicate();
+            predicate = hasNegativePredicate ? composeOperand(Operand(subtract, sign.swizzle, true), Operand(predicate.value, predicate.swizzle))
+                                             : composeOperand(sign, Operand(predicate.value, predicate.swizzle));
+        } else {
+            Operand operand = user->getSourceAt(0);
+            std::vector<Operand> sources = user->getSources();
+            sources[0] = composeOperand(sign, Operand(operand.value, operand.swizzle));
+            if((trueIfNegative == 1) != operand.negate) {
+                std::swap(sources[1], sources[2]);
+            }
+            user->setOpcode(Opcode::CMP, sources);
+        }
+    }
+}
+
+void selectInstructions(Program &program) {
+    std::unordered_map<const Value *, std::vector<Use>> uses = getUses(program);
+    for(Instruction *instruction: program.getInstructions()) {
+        if(selectMultiplyAdd(instruction, uses)) {
+            selectInterpolation(instruction, uses);
+        }
+    }
+
+    // fusing moved the uses of the subtrees into their users
+    uses = getUses(program);
+    for(Instruction *instruction: program.getInstructions()) {
+        selectCondition(instruction, uses);
+    }
+}
+
+
+/**********************************************************************************
+ * Superword Level Parallelism
+ **********************************************************************************/
+/* A scalar computation that can become one component of a vector instruction */
+static bool isVectorizable(const Instruction *instruction) {
+    return instruction->getNumberComponents() == 1 && !instruction->isPredicated() && instruction->getMerge() == nullptr &&
+        instruction->getOpcode() != Opcode::MOV && isComponentWiseOpcode(instruction->getOpcode());
+}
+
+/* A merge cannot be swizzled, so a scalar read as a merge must stay in the first component */
+static bool isReadAsMerge(const Instruction *instruction, const std::unordered_map<const Value *, std::vector<Use>> &uses) {
+    auto fit = uses.find(instruction);
+    if(fit != uses.end()) {
+        for(const Use &use: fit->second) {
+            if(use.kind == Use::Kind::Merge) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* Isomorphic scalar instructions read the same values (or any constants) in every source */
+static std::string getIsomorphismKey(const Instruction *instruction) {
+    std::string key = getOpcodeString(instruction->getOpcode()) + " " + std::to_string(instruction->getDataType());
+    for(const Operand &src: instruction->getSources()) {
+        key += " " + (src.value->isConstant() ? std::string("const") : (src.negate ? "-" : "") + src.value->getName());
+    }
+    return key;
+}
+
+/* Replaces the group of scalar instructions by one vector instruction before the first of them */
+static void vectorizeGroup(Program &program, const std::vector<Instruction *> &group,
+    std::unordered_map<const Value *, Operand> &replacements) {
+    Instruction *first = group.front();
+    unsigned numberComponents = group.size();
+    int dataType = SEMA::getDataType(SEMA::getDataTypeBaseType(first->getDataType()), numberComponents);
+
+    std::vector<Operand> sources;
+    for(unsigned s = 0; s < first->getSources().size(); s++) {
+        const Operand &src = first->getSourceAt(s);
+        if(src.value->isConstant()) {
+            std::array<float, 4> values = {{0.0, 0.0, 0.0, 0.0}};
+            for(unsigned i = 0; i < numberComponents; i++) {
+                values[i] = getConstantOperandValue(group[i]->getSourceAt(s), 0);
+            }
+            sources.emplace_back(program.createConstant(dataType, values));
+        } else {
+            std::array<unsigned, 4> components = {{0, 0, 0, 0}};
+            for(unsigned i = 0; i < numberComponents; i++) {
+                components[i] = group[i]->getSourceAt(s).swizzle.getComponent(0);
+            }
+            sources.emplace_back(src.value, Swizzle::fromComponents(components, getFullWriteMask(numberComponents)), src.negate);
+        }
+    }
+
+    Instruction *vector = program.insertInstruction(first, dataType, first->getOpcode(), sources);
+    vector->setAnnotations(std::vector<std::string>(first->getAnnotations()));
+    first->setAnnotations({});
+    for(unsigned i = 0; i < numberComponents; i++) {
+        replacements[group[i]] = Operand(vector, Swizzle::replicate(i));
+    }
+}
+
+/* The masked write b = OP.mask (sources) else a, where a = OP (sources of the same values) is read by nothing else */
+static bool mergeComponentWrites(Program &program, Instruction *instruction,
+    const std::unordered_map<const Value *, std::vector<Use>> &uses) {
+    Value *merge = instruction->getMerge();
+    if(instruction->isPredicated() || !instruction->isMasked() || merge == nullptr || !merge->isInstruction() ||
+        !isComponentWiseOpcode(instruction->getOpcode())) {
+        return false;
+    }
+    Instruction *previous = static_cast<Instruction *>(merge);
+    if(previous->getOpcode() != instruction->getOpcode() || previous->isPredicated() ||
+        previous->getDataType() != instruction->getDataType() || uses.at(previous).size() != 1) {
+        return false;
+    }
+
+    WriteMask writeMask = instruction->getWriteMask();
+    WriteMask previousMask = previous->getWriteMask() & ~writeMask;
+    std::vector<Operand> sources;
+    for(unsigned s = 0; s < instruction->getSources().size(); s++) {
+        const Operand &src = instruction->getSourceAt(s);
+        const Operand &previousSrc = previous->getSourceAt(s);
+        if(src.value->isConstant() && previousSrc.value->isConstant()) {
+            std::array<float, 4> values = {{0.0, 0.0, 0.0, 0.0}};
+            for(unsigned i = 0; i < 4; i++) {
+                if(writeMask & (1u << i)) {
+                    values[i] = getConstantOperandValue(src, i);
+                } else if(previousMask & (1u << i)) {
+                    values[i] = getConstantOperandValue(previousSrc, i);
+                }
+            }
+            sources.emplace_back(program.createConstant(instruction->getDataType(), values));
+        } else if(src.value == previousSrc.value && src.negate == previousSrc.negate) {
+            std::array<unsigned, 4> components = {{0, 0, 0, 0}};
+            for(unsigned i = 0; i < 4; i++) {
+                components[i] = ((writeMask & (1u << i)) ? src : previousSrc).swizzle.getComponent(i);
+            }
+            sources.emplace_back(src.value, Swizzle::fromComponents(components, writeMask | previousMask), src.negate);
+        } else {
+            return false;
+        }
+    }
+
+    WriteMask mergedMask = writeMask | previous->getWriteMask();
+    bool isFull = (mergedMask == getFullWriteMask(instruction->getNumberComponents()));
+    instruction->setOpcode(instruction->getOpcode(), sources);
+    instruction->setWriteMask(mergedMask, isFull ? nullptr : previous->getMerge());
+    return true;
+}
+
+/*
+    Scalar instructions reading the same values are grouped in program order, a group becomes one vector
+    instruction placed before its first member, so every member must only read values defined before that.
+    Masked writes to the components of one vector from the same values are merged into a single write.
+*/
+void vectorizeScalars(Program &program) {
+    std::unordered_map<const Value *, std::vector<Use>> uses = getUses(program);
+    std::unordered_map<const Value *, unsigned> positions;
+    for(const Instruction *instruction: program.getInstructions()) {
+        positions.emplace(instruction, positions.size());
+    }
+    auto isDefinedBefore = [&](const Value *value, const Instruction *instruction) {
+        return !value->isInstruction() || positions.at(value) < positions.at(instruction);
+    };
+
+    std::vector<std::vector<Instruction *>> groups;
+    std::unordered_map<std::string, unsigned> openGroups;
+    std::vector<Instruction *> instructions = program.getInstructions();
+    for(Instruction *instruction: instructions) {
+        if(!isVectorizable(instruction)) {
+            continue;
+        }
+
+        std::string key = getIsomorphismKey(instruction);
+        auto fit = openGroups.find(key);
+        if(fit != openGroups.end() && !isReadAsMerge(instruction, uses)) {
+            std::vector<Instruction *> &group = groups[fit->second];
+            bool isIndependent = true;
+            for(const Operand &src: instruction->getSources()) {
+                isIndependent = isIndependent && isDefinedBefore(src.value, group.front());
+            }
+            if(isIndependent) {
+                group.push_back(instruction);
+                if(group.size() == 4) {
+                    openGroups.erase(fit);
+                }
+                continue;
+            }
+        }
+        openGroups[key] = groups.size();
+        groups.push_back({instruction});
+    }
+
+    std::unordered_map<const Value *, Operand> replacements;
+    std::unordered_set<const Instruction *> vectorizedInstructions;
+    for(const std::vector<Instruction *> &group: groups) {
+        if(group.size() >= 2) {
+            vectorizeGroup(program, group, replacements);
+            vectorizedInstructions.insert(group.begin(), group.end());
+        }
+    }
+
+    auto replace = [&](Operand &operand) {
+        auto fit = replacements.find(operand.value);
+        if(fit != replacements.end()) {
+            operand = Operand(fit->second.value, fit->second.swizzle, operand.negate);
+        }
+    };
+    for(Instruction *instruction: program.getInstructions()) {
+        for(Operand &src: instruction->getSources()) {
+            replace(src);
+        }
+        if(instruction->isPredicated()) {
+            replace(instruction->getPredicate());
+        }
+        if(instruction->getMerge() != nullptr) {
+            Operand merge(instruction->getMerge());
+            replace(merge);
+            assert(merge.swizzle.isIdentity() || merge.swizzle == Swizzle::replicate(0));
+            instruction->setMerge(merge.value);
+        }
+    }
+    for(Output &output: program.getOutputs()) {
+        replace(output.value);
+    }
+    if(!vectorizedInstructions.empty()) {
+        program.removeInstructions(vectorizedInstructions);
+    }
+
+    // the components are written from the same vector now
+    uses = getUses(program);
+    std::unordered_set<const Instruction *> mergedInstructions;
+    for(Instruction *instruction: program.getInstructions()) {
+        const Value *merge = instruction->getMerge();
+        if(mergeComponentWrites(program, instruction, uses)) {
+            mergedInstructions.insert(static_cast<const Instruction *>(merge));
+        }
+    }
+    if(!mergedInstructions.empty()) {
+        program.removeInstructions(mergedInstructions);
+    }
+}
+
+
+
+/**********************************************************************************
+ * Uniform Expression Hoisting
+ **********************************************************************************/
+static std::string getExpressionString(const Value *value);
+
+static std::string getExpressionString(const Operand &operand) {
+    return (operand.negate ? "-" : "") + getExpressionString(operand.value) + operand.swizzle.getString();
+}
+
+/*
+ * The computation of a value in ARB opcodes, registers and constants, as in MUL(program.env[1], {2,1}.xxxy).
+ * Constants are written with 9 significant digits, which read back as the same float, so equal strings are
+ * equal computations and the host evaluates exactly the constants of the program
+ */
+static std::string getExpressionString(const Value *value) {
+    std::stringstream ss;
+    if(value->isConstant()) {
+        const Constant *constant = static_cast<const Constant *>(value);
+        ss << "{";
+        for(unsigned i = 0; i < constant->getNumberComponents(); i++) {
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.9g", constant->getValueAt(i));
+            ss << (i == 0 ? "" : ",") << buffer;
+        }
+        ss << "}";
+    } else if(value->isRegister()) {
+        ss << static_cast<const Register *>(value)->getRegName();
+    } else {
+        const Instruction *instruction = static_cast<const Instruction *>(value);
+        ss << getOpcodeString(instruction->getOpcode()) << "(";
+        for(unsigned i = 0; i < instruction->getSources().size(); i++) {
+            ss << (i == 0 ? "" : ", ") << getExpressionString(instruction->getSourceAt(i));
+        }
+        ss << ")";
+    }
+    return ss.str();
+}
+
+std::vector<HoistedExpression> hoistUniformExpressions(Program &program, const std::unordered_set<std::string> &uniformRegNames) {
+    // plain computations of constants, uniform registers and other uniform computations, reading at least one uniform
+    std::unordered_set<const Value *> uniformValues;
+    for(const Instruction *instruction: program.getInstructions()) {
+        if(instruction->isPredicated() || instruction->getMerge() != nullptr || instruction->isMasked()) {
+            continue;
+        }
+
+        bool isUniform = true;
+        bool readsUniform = false;
+        for(const Operand &src: instruction->getSources()) {
+            if(src.value->isRegister()) {
+                bool isUniformRegister = uniformRegNames.count(static_cast<const Register *>(src.value)->getRegName()) == 1;
+                isUniform = isUniform && isUniformRegister;
+                readsUniform = readsUniform || isUniformRegister;
+            } else if(src.value->isInstruction()) {
+                isUniform = isUniform && uniformValues.count(src.value) == 1;
+                readsUniform = true;
+            }
+        }
+        if(isUniform && readsUniform) {
+            uniformValues.insert(instruction);
+        }
+    }
+
+    // the largest uniform computations are the ones read by a per fragment instruction or a result register
+    std::vector<HoistedExpression> hoistedExpressions;
+    std::unordered_map<const Value *, Register *> hoistedRegisters;
+    std::unordered_map<const Value *, std::vector<Use>> uses = getUses(program);
+    for(const Instruction *instruction: program.getInstructions()) {
+        if(uniformValues.count(instruction) == 0) {
+            continue;
+        }
+        bool isRoot = false;
+        for(const Use &use: uses[instruction]) {
+            isRoot = isRoot || use.kind == Use::Kind::Output || uniformValues.count(use.instruction) == 0;
+        }
+        if(!isRoot) {
+            continue;
+        }
+
+        // the same computation is hoisted once, before value numbering it may appear more than once
+        std::string expression = getExpressionString(instruction);
+        Register *reg = nullptr;
+        for(const HoistedExpression &hoistedExpression: hoistedExpressions) {
+            if(hoistedExpression.expression == expression && hoistedExpression.dataType == instruction->getDataType()) {
+                reg = program.createRegister(hoistedExpression.dataType, hoistedExpression.regName);
+            }
+        }
+        if(reg == nullptr) {
+            std::string regName = "program.local[" + std::to_string(hoistedExpressions.size()) + "]";
+            hoistedExpressions.push_back({regName, instruction->getDataType(), expression});
+            reg = program.createRegister(instruction->getDataType(), regName);
+        }
+        hoistedRegisters[instruction] = reg;
+    }
+
+    // the hoisted computations are left dead
+    auto replace = [&](Value *value) -> Value * {
+        auto fit = hoistedRegisters.find(value);
+        return (fit == hoistedRegisters.end()) ? value : fit->second;
+    };
+    for(Instruction *instruction: program.getInstructions()) {
+        for(Operand &src: instruction->getSources()) {
+            src.value = replace(src.value);
+        }
+        if(instruction->isPredicated()) {
+            instruction->getPredicate().value = replace(instruction->getPredicate().value);
+        }
+        if(instruction->getMerge() != nullptr) {
+            instruction->setMerge(replace(instruction->getMerge()));
+        }
+    }
+    for(Output &output: program.getOutputs()) {
+        output.value.value = replace(output.value.value);
+    }
+
+    return hoistedExpressions;
+}
+
+} /* END NAMESPACE */
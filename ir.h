@@ -0,0 +1,310 @@
+#ifndef IR_H_INCLUDED
+#define IR_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+/*
+    Typed SSA Intermediate Representation between the AST and the ARB assembly.
+
+    Every Value is defined exactly once and has a data type (types defined in parser.tab.h).
+    Fragment programs are straight-line, if statements are converted into predicated
+    Instructions, so there is no control flow and no phi node.
+*/
+namespace IR{
+
+enum class Opcode {
+    MOV,
+    ADD,
+    SUB,
+    MUL,
+    RCP,
+    POW,
+    DP3,
+    LIT,
+    RSQ,
+    MAX,
+    MIN,
+    ABS,
+    CMP,
+    MAD,
+    LRP,
+    SGE,
+    DP4
+};
+
+std::string getOpcodeString(Opcode opCode);
+unsigned getOpcodeNumberSources(Opcode opCode);
+bool isScalarOpcode(Opcode opCode);                 // reads the first swizzled component, replicates the result
+bool isComponentWiseOpcode(Opcode opCode);          // each result component reads the same component of the sources
+
+/* Bit i set if component i (x, y, z, w) is written */
+using WriteMask = unsigned;
+
+WriteMask getFullWriteMask(unsigned numberComponents);
+std::string getWriteMaskString(WriteMask writeMask);
+
+class Swizzle {
+    private:
+        std::array<unsigned, 4> m_components = {{0, 1, 2, 3}};
+
+    public:
+        Swizzle() = default;
+        Swizzle(unsigned x, unsigned y, unsigned z, unsigned w): m_components{{x, y, z, w}} {}
+
+    public:
+        static Swizzle replicate(unsigned component) { return Swizzle(component, component, component, component); }
+        /* Components outside of the mask are free, and chosen for the shortest string */
+        static Swizzle fromComponents(const std::array<unsigned, 4> &components, unsigned componentMask);
+
+    public:
+        unsigned getComponent(unsigned i) const { return m_components.at(i); }
+        bool isIdentity() const;
+        bool isReplicate() const;
+        std::string getString() const;              // "" for identity, ".x" for replicate, ".xyzw" otherwise
+
+        friend bool operator==(const Swizzle &lhs, const Swizzle &rhs) { return lhs.m_components == rhs.m_components; }
+        friend bool operator!=(const Swizzle &lhs, const Swizzle &rhs) { return !(lhs == rhs); }
+};
+
+class Value {
+    public:
+        enum class Kind {
+            Constant,
+            Register,
+            Instruction
+        };
+
+    private:
+        Kind m_kind;
+        unsigned m_id;
+        int m_dataType;                             // types defined in parser.tab.h
+
+    protected:
+        Value(Kind kind, unsigned id, int dataType): m_kind(kind), m_id(id), m_dataType(dataType) {}
+
+    public:
+        virtual ~Value() = default;
+
+    public:
+        Kind getKind() const { return m_kind; }
+        bool isConstant() const { return m_kind == Kind::Constant; }
+        bool isRegister() const { return m_kind == Kind::Register; }
+        bool isInstruction() const { return m_kind == Kind::Instruction; }
+        unsigned getId() const { return m_id; }
+        int getDataType() const { return m_dataType; }
+        unsigned getNumberComponents() const;
+        std::string getName() const { return "%" + std::to_string(m_id); }
+};
+
+/* Compile-time known value */
+class Constant: public Value {
+    private:
+        std::array<float, 4> m_values;
+
+    public:
+        Constant(unsigned id, int dataType, const std::array<float, 4> &values):
+            Value(Kind::Constant, id, dataType), m_values(values) {}
+
+    public:
+        const std::array<float, 4> &getValues() const { return m_values; }
+        float getValueAt(unsigned i) const { return m_values.at(i); }
+};
+
+/* Named ARB register, defined outside of the program (attributes, state, program environment, user PARAMs) */
+class Register: public Value {
+    private:
+        std::string m_regName;
+
+    public:
+        Register(unsigned id, int dataType, const std::string &regName):
+            Value(Kind::Register, id, dataType), m_regName(regName) {}
+
+    public:
+        const std::string &getRegName() const { return m_regName; }
+};
+
+struct Operand {
+    Value *value = nullptr;
+    Swizzle swizzle;
+    bool negate = false;
+
+    Operand() = default;
+    Operand(Value *value, Swizzle swizzle = Swizzle(), bool negate = false):
+        value(value), swizzle(swizzle), negate(negate) {}
+
+    bool isValid() const { return value != nullptr; }
+    std::string getString() const;
+
+    friend bool operator==(const Operand &lhs, const Operand &rhs) {
+        return lhs.value == rhs.value && lhs.swizzle == rhs.swizzle && lhs.negate == rhs.negate;
+    }
+    friend bool operator!=(const Operand &lhs, const Operand &rhs) { return !(lhs == rhs); }
+};
+
+/*
+    result = Opcode(sources), for components in write mask and where predicate is not negative;
+    all other components come from merge (undefined if merge is nullptr).
+*/
+class Instruction: public Value {
+    private:
+        Opcode m_opCode;
+        std::vector<Operand> m_sources;
+        WriteMask m_writeMask;
+        Value *m_merge = nullptr;
+        Operand m_predicate;
+
+        std::string m_variableName;                 // register name of the assigned variable (optional)
+        std::vector<std::string> m_annotations;     // comments prior to the instruction
+
+    public:
+        Instruction(unsigned id, int dataType, Opcode opCode, const std::vector<Operand> &sources);
+
+    public:
+        Opcode getOpcode() const { return m_opCode; }
+        const std::vector<Operand> &getSources() const { return m_sources; }
+        std::vector<Operand> &getSources() { return m_sources; }
+        const Operand &getSourceAt(unsigned i) const { return m_sources.at(i); }
+        WriteMask getWriteMask() const { return m_writeMask; }
+        bool isMasked() const { return m_writeMask != getFullWriteMask(getNumberComponents()); }
+        Value *getMerge() const { return m_merge; }
+        const Operand &getPredicate() const { return m_predicate; }
+        Operand &getPredicate() { return m_predicate; }
+        bool isPredicated() const { return m_predicate.isValid(); }
+        WriteMask getSourceReadMask() const;        // components of the sources that can affect the result
+        WriteMask getMergeReadMask() const;         // components of the merge that can be kept
+        const std::string &getVariableName() const { return m_variableName; }
+        const std::vector<std::string> &getAnnotations() const { return m_annotations; }
+
+    public:
+        void setOpcode(Opcode opCode, const std::vector<Operand> &sources) { m_opCode = opCode; m_sources = sources; }
+        void setWriteMask(WriteMask writeMask, Value *merge) { m_writeMask = writeMask; m_merge = merge; }
+        void setMerge(Value *merge) { m_merge = merge; }
+        void setPredicate(const Operand &predicate, Value *merge) { m_predicate = predicate; m_merge = merge; }
+        void setVariableName(const std::string &variableName) { m_variableName = variableName; }
+        void addAnnotation(const std::string &annotation) { m_annotations.push_back(annotation); }
+        void setAnnotations(std::vector<std::string> &&annotations) { m_annotations = std::move(annotations); }
+
+    public:
+        /* Visit every Value read by this instruction: sources, predicate and merge */
+        template <typename Func>
+        void forEachOperandValue(Func func) const {
+            for(const Operand &src: m_sources) {
+                func(src.value);
+            }
+            if(m_predicate.isValid()) {
+                func(m_predicate.value);
+            }
+            if(m_merge != nullptr) {
+                func(m_merge);
+            }
+        }
+
+        std::string generateCode() const;
+};
+
+/* Final value of a result register */
+struct Output {
+    std::string regName;
+    Operand value;
+};
+
+class Program {
+    private:
+        std::vector<std::unique_ptr<Value>> m_values;       // Ownership of all Values
+        std::vector<Instruction *> m_instructions;          // Instructions in program order
+        std::vector<Output> m_outputs;
+
+        Constant *m_trueConstant = nullptr;
+        Constant *m_falseConstant = nullptr;
+        Constant *m_zeroConstant = nullptr;
+
+    public:
+        Program();
+
+        Program(const Program &) = delete;
+        Program &operator=(const Program &) = delete;
+        Program(Program &&) = default;
+        Program &operator=(Program &&) = default;
+
+    public:
+        Constant *createConstant(int dataType, const std::array<float, 4> &values);
+        Register *createRegister(int dataType, const std::string &regName);
+        Instruction *createInstruction(int dataType, Opcode opCode, const std::vector<Operand> &sources);
+        Instruction *insertInstruction(const Instruction *before, int dataType, Opcode opCode, const std::vector<Operand> &sources);
+
+        Constant *getTrueConstant() const { return m_trueConstant; }
+        Constant *getFalseConstant() const { return m_falseConstant; }
+        Constant *getZeroConstant() const { return m_zeroConstant; }
+
+    public:
+        const std::vector<Instruction *> &getInstructions() const { return m_instructions; }
+        const std::vector<Output> &getOutputs() const { return m_outputs; }
+        std::vector<Output> &getOutputs() { return m_outputs; }
+        void setOutput(const std::string &regName, const Operand &value);
+
+        /* Annotations of a removed instruction move to the next remaining instruction, if it has none */
+        void removeInstructions(const std::unordered_set<const Instruction *> &instructions);
+
+    public:
+        std::vector<std::string> generateCode() const;
+        void dump() const;
+        void verify() const;
+};
+
+/*
+    Optimization passes
+*/
+
+/* Removes every instruction that does not contribute to an Output, result registers are the only roots */
+void eliminateDeadCode(Program &program);
+
+/* Forwards the sources of MOVs (including negation and swizzles) into their users, the MOVs are left dead */
+void propagateCopies(Program &program);
+
+/* Registers with a value known at compile time (by register name) become constants, for specialized programs */
+void bindRegisterValues(Program &program, const std::map<std::string, std::array<float, 4>> &registerValues);
+
+/* Lanes of the operand if it only depends on constants and the assumed values, before any folding */
+bool evaluateOperand(const Operand &operand, const std::unordered_map<const Value *, std::array<float, 4>> &assumedValues,
+    std::array<float, 4> &values);
+
+/* Sparse conditional constant propagation, including predicates known at compile time */
+void foldConstants(Program &program);
+
+/* POW with a small integer or half integer exponent becomes MUL, RCP and RSQ */
+void reduceStrength(Program &program);
+
+/* Assignments to a variable in both branches of an if statement become a single select */
+void mergeSelects(Program &program);
+
+/* Fast math only: reassociates and distributes ADD, SUB and MUL over constants, x*0 and x-x become 0 */
+void reassociate(Program &program);
+
+/* Global value numbering, users of a recomputed value read the first computation instead */
+void numberValues(Program &program);
+
+/* Superword level parallelism, isomorphic scalar instructions become one vector instruction */
+void vectorizeScalars(Program &program);
+
+/* Instruction selection, fuses expression trees into MAD, LRP and SGE and conditions into their comparison */
+void selectInstructions(Program &program);
+
+/* Computation moved out of the fragment program, which the host evaluates once per draw into a register */
+struct HoistedExpression {
+    std::string regName;                            // program.local[n]
+    int dataType;
+    std::string expression;                         // ARB opcodes over uniform registers and constants
+};
+
+/* Computations that only read uniform registers (by name) and constants are read from program.local[] registers instead */
+std::vector<HoistedExpression> hoistUniformExpressions(Program &program, const std::unordered_set<std::string> &uniformRegNames);
+
+}
+
+#endif
@@ -55,8 +55,8 @@ extern int yyline;        /* variable holding current line number   */
   int as_int;
   float as_float;
   
-  char as_id[MAX_IDENTIFIER + 1];
-  char as_func[MAX_IDENTIFIER + 1];
+  AST::SymbolID as_id;
+  AST::SymbolID as_func;
 
   /* Parser */
   int op_type;
@@ -238,7 +238,7 @@ function
   :  function_name LPAREN arguments_opt RPAREN    %prec V_F_C_PREC  { yTRACE("function -> function_name ( arguments_opt )");              $$ = ast_allocate(FUNCTION_NODE, $1, $3, &@$);                                        }
   ;
 function_name
-  :  FUNC                                                           { yTRACE("function_name -> lit | dp3 | rsq");                         strcpy($$, $1);                                                                       }
+  :  FUNC                                                           { yTRACE("function_name -> lit | dp3 | rsq");                         $$ = $1;                                                                              }
   ;
 arguments_opt
   :  arguments                                                      { yTRACE("arguments_opt -> arguments");                               $$ = $1;                                                                              }
@@ -24,22 +24,26 @@
 
 namespace SEMA{ /* START NAMESPACE */
 
-const std::vector<std::string> l_predefinedVariableNames = {
-    "gl_FragColor",
-    "gl_FragDepth",
-    "gl_FragCoord",
-    "gl_TexCoord",
-    "gl_Color",
-    "gl_Secondary",
-    "gl_FogFragCoord",
-    "gl_Light_Half",
-    "gl_Light_Ambient",
-    "gl_Material_Shininess",
-    "env1",
-    "env2",
-    "env3"
+const std::unordered_set<AST::SymbolID> l_predefinedVariableNames = {
+    AST::internSymbol("gl_FragColor"),
+    AST::internSymbol("gl_FragDepth"),
+    AST::internSymbol("gl_FragCoord"),
+    AST::internSymbol("gl_TexCoord"),
+    AST::internSymbol("gl_Color"),
+    AST::internSymbol("gl_Secondary"),
+    AST::internSymbol("gl_FogFragCoord"),
+    AST::internSymbol("gl_Light_Half"),
+    AST::internSymbol("gl_Light_Ambient"),
+    AST::internSymbol("gl_Material_Shininess"),
+    AST::internSymbol("env1"),
+    AST::internSymbol("env2"),
+    AST::internSymbol("env3")
 };
 
+const AST::SymbolID l_rsqFunctionName = AST::internSymbol("rsq");
+const AST::SymbolID l_dp3FunctionName = AST::internSymbol("dp3");
+const AST::SymbolID l_litFunctionName = AST::internSymbol("lit");
+
 class SourceContext {
     private:
         std::vector<std::string> m_sourceFile;
@@ -123,14 +127,15 @@ class SemanticAnalyzer {
         using EventID = size_t;
 
     private:
-        std::vector<std::unique_ptr<Event>> m_eventList;
-        std::unordered_map<const AST::ASTNode *, std::vector<EventID>> m_astEventLU;
+        /* Append-only, events are stored in place and only ever referred to by EventID */
+        std::vector<Event> m_eventList;
 
         std::vector<EventID> m_errorEventList;
         std::vector<EventID> m_warningEventList;
 
     private:
-        std::unique_ptr<Event> m_tempEvent = nullptr;
+        /* Reused in place, its strings stay empty unless a check fails */
+        Event m_tempEvent = Event(nullptr, EventType::Unknown);
         bool m_tempEventValid = false;
 
     private:
@@ -140,10 +145,9 @@ class SemanticAnalyzer {
     public:
         void resetAnalyzer() {
             m_eventList.clear();
-            m_astEventLU.clear();
             m_errorEventList.clear();
             m_warningEventList.clear();
-            m_tempEvent.reset();
+            m_tempEvent = Event(nullptr, EventType::Unknown);
             m_tempEventValid = false;
         }
     
@@ -185,9 +189,8 @@ SemanticAnalyzer::EventID SemanticAnalyzer::createEvent(const AST::ASTNode *astN
     assert(astNode != nullptr);
     assert(eventType != EventType::Unknown);
 
-    m_eventList.emplace_back(new Event(astNode, eventType));
+    m_eventList.emplace_back(astNode, eventType);
     EventID id = m_eventList.size() - 1;
-    m_astEventLU[astNode].push_back(id);
     if(eventType == EventType::Error) {
         m_errorEventList.push_back(id);
     } else {
@@ -198,15 +201,15 @@ SemanticAnalyzer::EventID SemanticAnalyzer::createEvent(const AST::ASTNode *astN
 }
 
 SemanticAnalyzer::Event &SemanticAnalyzer::getEvent(EventID eventID) {
-    return *(m_eventList.at(eventID));
+    return m_eventList.at(eventID);
 }
 
 const SemanticAnalyzer::Event &SemanticAnalyzer::getEventC(EventID eventID) const {
-    return *(m_eventList.at(eventID));
+    return m_eventList.at(eventID);
 }
 
 const SemanticAnalyzer::Event &SemanticAnalyzer::getEvent(EventID eventID) const {
-    return *(m_eventList.at(eventID));
+    return m_eventList.at(eventID);
 }
 
 void SemanticAnalyzer::printEventNoColor(EventID eventID, const SourceContext &sourceContext) const {
@@ -375,46 +378,41 @@ void SemanticAnalyzer::printEvent(EventID eventID, const SourceContext &sourceCo
 
 void SemanticAnalyzer::createTempEvent(const AST::ASTNode *astNode, EventType eventType) {
     assert(m_tempEventValid == false);
-    assert(m_tempEvent == nullptr);
     m_tempEventValid = true;
-    m_tempEvent.reset(new Event(astNode, eventType));
+    setTempEventASTNode(astNode);
+    setTempEventEventType(eventType);
 }
 
 void SemanticAnalyzer::setTempEventASTNode(const AST::ASTNode *astNode) {
     assert(m_tempEventValid == true);
-    assert(m_tempEvent != nullptr);
-    m_tempEvent->m_astNode = astNode;
+    m_tempEvent.m_astNode = astNode;
 }
 
 void SemanticAnalyzer::setTempEventEventType(EventType eventType) {
     assert(m_tempEventValid == true);
-    assert(m_tempEvent != nullptr);
-    m_tempEvent->m_eventType = eventType;
+    m_tempEvent.m_eventType = eventType;
 }
 
 void SemanticAnalyzer::dropTempEvent() {
     assert(m_tempEventValid == true);
-    assert(m_tempEvent != nullptr);
     m_tempEventValid = false;
-    m_tempEvent.reset(nullptr);
+    m_tempEvent = Event(nullptr, EventType::Unknown);
 }
 
 SemanticAnalyzer::EventID SemanticAnalyzer::promoteTempEvent() {
     assert(m_tempEventValid == true);
-    assert(m_tempEvent != nullptr);
 
-    EventType eventType = m_tempEvent->getEventType();
-    const AST::ASTNode *astNode = m_tempEvent->getASTNode();
+    EventType eventType = m_tempEvent.getEventType();
+    const AST::ASTNode *astNode = m_tempEvent.getASTNode();
     assert(eventType != EventType::Unknown);
     assert(astNode != nullptr);
 
     m_tempEventValid = false;
     m_eventList.push_back(std::move(m_tempEvent));
-    assert(m_tempEvent == nullptr);
+    m_tempEvent = Event(nullptr, EventType::Unknown);
 
     EventID id = m_eventList.size() - 1;
 
-    m_astEventLU[astNode].push_back(id);
     if(eventType == EventType::Error) {
         m_errorEventList.push_back(id);
     } else {
@@ -426,20 +424,17 @@ SemanticAnalyzer::EventID SemanticAnalyzer::promoteTempEvent() {
 
 SemanticAnalyzer::Event &SemanticAnalyzer::getTempEvent() {
     assert(m_tempEventValid == true);
-    assert(m_tempEvent != nullptr);
-    return *m_tempEvent;
+    return m_tempEvent;
 }
 
 const SemanticAnalyzer::Event &SemanticAnalyzer::getTempEventC() const {
     assert(m_tempEventValid == true);
-    assert(m_tempEvent != nullptr);
-    return *m_tempEvent;
+    return m_tempEvent;
 }
 
 const SemanticAnalyzer::Event &SemanticAnalyzer::getTempEvent() const {
     assert(m_tempEventValid == true);
-    assert(m_tempEvent != nullptr);
-    return *m_tempEvent;
+    return m_tempEvent;
 }
 
 class PredefinedVariableCreater: public AST::Visitor {
@@ -465,55 +460,55 @@ class PredefinedVariableCreater: public AST::Visitor {
             */
 
             // result vec4 gl_FragColor ;
-            AST::DeclarationNode *node_gl_FragColor = new AST::DeclarationNode("gl_FragColor", false, VEC4_T);
+            AST::DeclarationNode *node_gl_FragColor = new AST::DeclarationNode(AST::internSymbol("gl_FragColor"), false, VEC4_T);
             node_gl_FragColor->setResultType();
 
             // result bool gl_FragDepth ;
-            AST::DeclarationNode *node_gl_FragDepth = new AST::DeclarationNode("gl_FragDepth", false, BOOL_T);
+            AST::DeclarationNode *node_gl_FragDepth = new AST::DeclarationNode(AST::internSymbol("gl_FragDepth"), false, BOOL_T);
             node_gl_FragDepth->setResultType();
 
             // attribute vec4 gl_FragCoord ;
-            AST::DeclarationNode *node_gl_FragCoord = new AST::DeclarationNode("gl_FragCoord", false, VEC4_T);
+            AST::DeclarationNode *node_gl_FragCoord = new AST::DeclarationNode(AST::internSymbol("gl_FragCoord"), false, VEC4_T);
             node_gl_FragCoord->setAttributeType();
 
             // attribute vec4 gl_TexCoord ;
-            AST::DeclarationNode *node_gl_TexCoord = new AST::DeclarationNode("gl_TexCoord", false, VEC4_T);
+            AST::DeclarationNode *node_gl_TexCoord = new AST::DeclarationNode(AST::internSymbol("gl_TexCoord"), false, VEC4_T);
             node_gl_TexCoord->setAttributeType();
 
             // attribute vec4 gl_Color;
-            AST::DeclarationNode *node_gl_Color = new AST::DeclarationNode("gl_Color", false, VEC4_T);
+            AST::DeclarationNode *node_gl_Color = new AST::DeclarationNode(AST::internSymbol("gl_Color"), false, VEC4_T);
             node_gl_Color->setAttributeType();
 
             // attribute vec4 gl_Secondary ;
-            AST::DeclarationNode *node_gl_Secondary = new AST::DeclarationNode("gl_Secondary", false, VEC4_T);
+            AST::DeclarationNode *node_gl_Secondary = new AST::DeclarationNode(AST::internSymbol("gl_Secondary"), false, VEC4_T);
             node_gl_Secondary->setAttributeType();
 
             // attribute vec4 gl_FogFragCoord ;
-            AST::DeclarationNode *node_gl_FogFragCoord = new AST::DeclarationNode("gl_FogFragCoord", false, VEC4_T);
+            AST::DeclarationNode *node_gl_FogFragCoord = new AST::DeclarationNode(AST::internSymbol("gl_FogFragCoord"), false, VEC4_T);
             node_gl_FogFragCoord->setAttributeType();
 
             // uniform vec4 gl_Light_Half ;
-            AST::DeclarationNode *node_gl_Light_Half = new AST::DeclarationNode("gl_Light_Half", false, VEC4_T);
+            AST::DeclarationNode *node_gl_Light_Half = new AST::DeclarationNode(AST::internSymbol("gl_Light_Half"), false, VEC4_T);
             node_gl_Light_Half->setUniformType();
 
             // uniform vec4 gl_Light_Ambient ;
-            AST::DeclarationNode *node_gl_Light_Ambient = new AST::DeclarationNode("gl_Light_Ambient", false, VEC4_T);
+            AST::DeclarationNode *node_gl_Light_Ambient = new AST::DeclarationNode(AST::internSymbol("gl_Light_Ambient"), false, VEC4_T);
             node_gl_Light_Ambient->setUniformType();
 
             // uniform vec4 gl_Material_Shininess ;
-            AST::DeclarationNode *node_gl_Material_Shininess = new AST::DeclarationNode("gl_Material_Shininess", false, VEC4_T);
+            AST::DeclarationNode *node_gl_Material_Shininess = new AST::DeclarationNode(AST::internSymbol("gl_Material_Shininess"), false, VEC4_T);
             node_gl_Material_Shininess->setUniformType();
 
             // uniform vec4 env1;
-            AST::DeclarationNode *node_env1 = new AST::DeclarationNode("env1", false, VEC4_T);
+            AST::DeclarationNode *node_env1 = new AST::DeclarationNode(AST::internSymbol("env1"), false, VEC4_T);
             node_env1->setUniformType();
 
             // uniform vec4 env2;
-            AST::DeclarationNode *node_env2 = new AST::DeclarationNode("env2", false, VEC4_T);
+            AST::DeclarationNode *node_env2 = new AST::DeclarationNode(AST::internSymbol("env2"), false, VEC4_T);
             node_env2->setUniformType();
 
             // uniform vec4 env3;
-            AST::DeclarationNode *node_env3 = new AST::DeclarationNode("env3", false, VEC4_T);
+            AST::DeclarationNode *node_env3 = new AST::DeclarationNode(AST::internSymbol("env3"), false, VEC4_T);
             node_env3->setUniformType();
 
             // Insert into AST
@@ -548,7 +543,7 @@ class SymbolDeclVisitor: public AST::Visitor {
 
         virtual void preNodeVisit(AST::DeclarationNode *declarationNode) {
             AST::DeclarationNode *redecl = nullptr;
-            if(std::count(l_predefinedVariableNames.begin(), l_predefinedVariableNames.end(), declarationNode->getName()) == 1) {
+            if(l_predefinedVariableNames.count(declarationNode->getSymbolID()) == 1) {
                 redecl = m_symbolTable.findAnyRedeclaration(declarationNode);
 
                 if(redecl == nullptr) {
@@ -600,38 +595,6 @@ class SymbolDeclVisitor: public AST::Visitor {
         }
 };
 
-/* Finds Write-Only Type in Expressions Only */
-class WriteOnlyFinder: public AST::Visitor {
-    private:
-        std::vector<const AST::VariableNode *> m_writeOnlyVars;
-    private:
-        virtual void postNodeVisit(AST::IdentifierNode *identifierNode) {
-            if(identifierNode->isWriteOnly()) {
-                m_writeOnlyVars.push_back(identifierNode);
-            }
-        }
-        virtual void postNodeVisit(AST::IndexingNode *indexingNode) {
-            if(indexingNode->isWriteOnly()) {
-                m_writeOnlyVars.push_back(indexingNode);
-            }
-        }
-    private:
-        /* Do not traverse into */
-        virtual void nodeVisit(AST::IndexingNode *indexingNode) {}
-        virtual void nodeVisit(AST::StatementNode *statementNode) {}
-        virtual void nodeVisit(AST::StatementsNode *statementsNode) {}
-        virtual void nodeVisit(AST::DeclarationNode *declarationNode) {}
-        virtual void nodeVisit(AST::DeclarationsNode *declarationsNode) {}
-        virtual void nodeVisit(AST::IfStatementNode *ifStatementNode) {}
-        virtual void nodeVisit(AST::AssignmentNode *assignmentNode) {}
-        virtual void nodeVisit(AST::StallStatementNode *stallStatementNode) {}
-        virtual void nodeVisit(AST::NestedScopeNode *nestedScopeNode) {}
-        virtual void nodeVisit(AST::ScopeNode *scopeNode) {}
-
-    public:
-        const std::vector<const AST::VariableNode *> &getWriteOnlyVars() const { return m_writeOnlyVars; }
-};
-
 DataTypeCategory getDataTypeCategory(int dataType) {
     switch(dataType) {
         case BOOL_T:
@@ -698,12 +661,40 @@ int getDataTypeBaseType(int dataType) {
     }
 }
 
+int getDataType(int baseType, int order) {
+    static const int boolTypes[] = {BOOL_T, BVEC2_T, BVEC3_T, BVEC4_T};
+    static const int intTypes[] = {INT_T, IVEC2_T, IVEC3_T, IVEC4_T};
+    static const int floatTypes[] = {FLOAT_T, VEC2_T, VEC3_T, VEC4_T};
+    assert(order >= 1 && order <= 4);
+    switch(baseType) {
+        case BOOL_T:
+            return boolTypes[order - 1];
+        case INT_T:
+            return intTypes[order - 1];
+        case FLOAT_T:
+            return floatTypes[order - 1];
+        default:
+            assert(0);
+    }
+}
+
+/* First write-only variable read by the argument list, in evaluation order */
+const AST::VariableNode *getFirstWriteOnlyVariable(const AST::ExpressionList &args) {
+    for(const AST::ExpressionNode *arg: args) {
+        if(const AST::VariableNode *writeOnlyVar = arg->getFirstWriteOnlyVariable()) {
+            return writeOnlyVar;
+        }
+    }
+    return nullptr;
+}
+
 class TypeChecker: public AST::Visitor {
     private:
         ST::SymbolTable &m_symbolTable;
         SEMA::SemanticAnalyzer &m_semaAnalyzer;
 
         int m_ifScopeCount = 0;
+        int m_whileScopeCount = 0;
     public:
         TypeChecker(ST::SymbolTable &symbolTable, SEMA::SemanticAnalyzer &semaAnalyzer):
             m_symbolTable(symbolTable), m_semaAnalyzer(semaAnalyzer) {}
@@ -711,6 +702,7 @@ class TypeChecker: public AST::Visitor {
     private:
         virtual void preNodeVisit(AST::IdentifierNode *identifierNode);
         virtual void preNodeVisit(AST::IfStatementNode *ifStatementNode);
+        virtual void preNodeVisit(AST::WhileStatementNode *whileStatementNode);
 
     private:
         virtual void postNodeVisit(AST::UnaryExpressionNode *unaryExpressionNode);
@@ -720,8 +712,13 @@ class TypeChecker: public AST::Visitor {
         virtual void postNodeVisit(AST::ConstructorNode *constructorNode);
         virtual void postNodeVisit(AST::DeclarationNode *declarationNode);
         virtual void postNodeVisit(AST::IfStatementNode *ifStatementNode);
+        virtual void postNodeVisit(AST::WhileStatementNode *whileStatementNode);
         virtual void postNodeVisit(AST::AssignmentNode *assignmentNode);
 
+    private:
+        /* statementKind is "If" or "While" */
+        void checkConditionExpression(AST::StatementNode *statementNode, AST::ExpressionNode *cond, const std::string &statementKind);
+
     private:
         int inferDataType(int op, int rhsDataType);
         int inferDataType(int op, int lhsDataType, int rhsDataType);
@@ -746,11 +743,12 @@ void TypeChecker::preNodeVisit(AST::IdentifierNode *identifierNode) {
         return;
     }
 
-    assert(decl->getName() == identifierNode->getName());
+    assert(decl->getSymbolID() == identifierNode->getSymbolID());
 
     // Update info in identifierNode
     identifierNode->setExpressionType(decl->getType());
     identifierNode->setDeclaration(decl);
+    identifierNode->setFirstWriteOnlyVariable(identifierNode->isWriteOnly() ? identifierNode : nullptr);
 }
 
 void TypeChecker::preNodeVisit(AST::IfStatementNode *ifStatementNode) {
@@ -758,21 +756,26 @@ void TypeChecker::preNodeVisit(AST::IfStatementNode *ifStatementNode) {
     m_ifScopeCount++;
 }
 
+void TypeChecker::preNodeVisit(AST::WhileStatementNode *whileStatementNode) {
+    assert(m_whileScopeCount >= 0);
+    m_whileScopeCount++;
+}
+
 void TypeChecker::postNodeVisit(AST::UnaryExpressionNode *unaryExpressionNode) {
     const AST::ExpressionNode *rhsExpr = unaryExpressionNode->getExpression();
     int rhsDataType = rhsExpr->getExpressionType();
     bool rhsIsConst = rhsExpr->isConst();
     int op = unaryExpressionNode->getOperator();
 
+    unaryExpressionNode->setFirstWriteOnlyVariable(rhsExpr->getFirstWriteOnlyVariable());
+
     int resultDataType = ANY_TYPE;
     if(rhsDataType != ANY_TYPE) {
         bool isLegal = true;
 
         // Firstly, check for Write-Only
-        WriteOnlyFinder writeOnlyFinder;
-        unaryExpressionNode->visit(writeOnlyFinder);
-        const std::vector<const AST::VariableNode *> &writeOnlyVars = writeOnlyFinder.getWriteOnlyVars();
-        if(!writeOnlyVars.empty()) {
+        const AST::VariableNode *writeOnlyVar = unaryExpressionNode->getFirstWriteOnlyVariable();
+        if(writeOnlyVar != nullptr) {
             isLegal = false;
 
             std::stringstream ss;
@@ -784,8 +787,8 @@ void TypeChecker::postNodeVisit(AST::UnaryExpressionNode *unaryExpressionNode) {
             m_semaAnalyzer.getEvent(id).EventLoc() = unaryExpressionNode->getSourceLocation();
 
             m_semaAnalyzer.getEvent(id).setUsingReference(true);
-            m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVars.front()->getName() + "':";
-            m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVars.front()->getSourceLocation();
+            m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVar->getName() + "':";
+            m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVar->getSourceLocation();
         }
 
         // Secondly, Type check
@@ -829,15 +832,16 @@ void TypeChecker::postNodeVisit(AST::BinaryExpressionNode *binaryExpressionNode)
 
     int op = binaryExpressionNode->getOperator();
 
+    const AST::VariableNode *lhsWriteOnlyVar = lhsExpr->getFirstWriteOnlyVariable();
+    binaryExpressionNode->setFirstWriteOnlyVariable(lhsWriteOnlyVar ? lhsWriteOnlyVar : rhsExpr->getFirstWriteOnlyVariable());
+
     int resultDataType = ANY_TYPE;
     if(lhsDataType != ANY_TYPE && rhsDataType != ANY_TYPE) {
         bool isLegal = true;
 
         // Firstly, check for Write-Only
-        WriteOnlyFinder writeOnlyFinder;
-        binaryExpressionNode->visit(writeOnlyFinder);
-        const std::vector<const AST::VariableNode *> &writeOnlyVars = writeOnlyFinder.getWriteOnlyVars();
-        if(!writeOnlyVars.empty()) {
+        const AST::VariableNode *writeOnlyVar = binaryExpressionNode->getFirstWriteOnlyVariable();
+        if(writeOnlyVar != nullptr) {
             isLegal = false;
 
             std::stringstream ss;
@@ -849,8 +853,8 @@ void TypeChecker::postNodeVisit(AST::BinaryExpressionNode *binaryExpressionNode)
             m_semaAnalyzer.getEvent(id).EventLoc() = binaryExpressionNode->getSourceLocation();
 
             m_semaAnalyzer.getEvent(id).setUsingReference(true);
-            m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVars.front()->getName() + "':";
-            m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVars.front()->getSourceLocation();
+            m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVar->getName() + "':";
+            m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVar->getSourceLocation();
         }
 
         // Secondly, Type check
@@ -934,6 +938,7 @@ void TypeChecker::postNodeVisit(AST::IndexingNode *indexingNode) {
     }
 
     indexingNode->setExpressionType(resultDataType);
+    indexingNode->setFirstWriteOnlyVariable(indexingNode->isWriteOnly() ? indexingNode : nullptr);
 }
 
 void TypeChecker::postNodeVisit(AST::FunctionNode *functionNode) {
@@ -942,10 +947,11 @@ void TypeChecker::postNodeVisit(AST::FunctionNode *functionNode) {
     bool legalFunctionCall = true;
 
     // Firstly, check for argument type
-    const std::string &funcName = functionNode->getName();
+    AST::SymbolID funcName = functionNode->getSymbolID();
     AST::ExpressionsNode *exprs = functionNode->getArgumentExpressions();
-    const std::vector<AST::ExpressionNode *> &args = exprs->getExpressionList();
-    if(funcName == "rsq") {
+    const AST::ExpressionList &args = exprs->getExpressionList();
+    functionNode->setFirstWriteOnlyVariable(getFirstWriteOnlyVariable(args));
+    if(funcName == l_rsqFunctionName) {
         bool isLegal = false;
         if(args.size() == 1) {
             const AST::ExpressionNode *arg1 = args.front();
@@ -972,7 +978,7 @@ void TypeChecker::postNodeVisit(AST::FunctionNode *functionNode) {
             m_semaAnalyzer.getEvent(id).setUsingReference(true);
             m_semaAnalyzer.getEvent(id).RefMessage() = "Expecting function argument 'float' or 'int'.";
         }
-    } else if (funcName == "dp3") {
+    } else if (funcName == l_dp3FunctionName) {
         bool isLegal = false;
         if(args.size() == 2) {
             const AST::ExpressionNode *arg1 = args[0];
@@ -1007,7 +1013,7 @@ void TypeChecker::postNodeVisit(AST::FunctionNode *functionNode) {
             m_semaAnalyzer.getEvent(id).RefMessage() =
                 "Expecting function arguments 'vec4, vec4' or 'vec3, vec3' or 'ivec4, ivec4' or 'ivec3, ivec3'.";
         }
-    } else if (funcName == "lit") {
+    } else if (funcName == l_litFunctionName) {
         bool isLegal = false;
         if(args.size() == 1) {
             const AST::ExpressionNode *arg1 = args.front();
@@ -1039,10 +1045,8 @@ void TypeChecker::postNodeVisit(AST::FunctionNode *functionNode) {
 
     // Secondly, check for Write-Only
     if(legalFunctionCall) {
-        WriteOnlyFinder writeOnlyFinder;
-        functionNode->visit(writeOnlyFinder);
-        const std::vector<const AST::VariableNode *> &writeOnlyVars = writeOnlyFinder.getWriteOnlyVars();
-        if(!writeOnlyVars.empty()) {
+        const AST::VariableNode *writeOnlyVar = functionNode->getFirstWriteOnlyVariable();
+        if(writeOnlyVar != nullptr) {
             resultDataType = ANY_TYPE;
 
             std::stringstream ss;
@@ -1054,8 +1058,8 @@ void TypeChecker::postNodeVisit(AST::FunctionNode *functionNode) {
             m_semaAnalyzer.getEvent(id).EventLoc() = functionNode->getSourceLocation();
 
             m_semaAnalyzer.getEvent(id).setUsingReference(true);
-            m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVars.front()->getName() + "':";
-            m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVars.front()->getSourceLocation();
+            m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVar->getName() + "':";
+            m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVar->getSourceLocation();
         }
     }
 
@@ -1080,7 +1084,8 @@ void TypeChecker::postNodeVisit(AST::ConstructorNode *constructorNode) {
     int constructorTypeBase = getDataTypeBaseType(constructorType);
     int constructorTypeOrder = getDataTypeOrder(constructorType);
     AST::ExpressionsNode *exprs = constructorNode->getArgumentExpressions();
-    const std::vector<AST::ExpressionNode *> &args = exprs->getExpressionList();
+    const AST::ExpressionList &args = exprs->getExpressionList();
+    constructorNode->setFirstWriteOnlyVariable(getFirstWriteOnlyVariable(args));
 
     bool argLegal = false;
     if(constructorTypeOrder == args.size()) {
@@ -1119,10 +1124,8 @@ void TypeChecker::postNodeVisit(AST::ConstructorNode *constructorNode) {
         m_semaAnalyzer.getEvent(id).RefMessage() = std::move(ss.str());
     } else {
         // Secondly, check for Write-Only
-        WriteOnlyFinder writeOnlyFinder;
-        constructorNode->visit(writeOnlyFinder);
-        const std::vector<const AST::VariableNode *> &writeOnlyVars = writeOnlyFinder.getWriteOnlyVars();
-        if(!writeOnlyVars.empty()) {
+        const AST::VariableNode *writeOnlyVar = constructorNode->getFirstWriteOnlyVariable();
+        if(writeOnlyVar != nullptr) {
             resultDataType = ANY_TYPE;
 
             std::stringstream ss;
@@ -1134,8 +1137,8 @@ void TypeChecker::postNodeVisit(AST::ConstructorNode *constructorNode) {
             m_semaAnalyzer.getEvent(id).EventLoc() = constructorNode->getSourceLocation();
 
             m_semaAnalyzer.getEvent(id).setUsingReference(true);
-            m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVars.front()->getName() + "':";
-            m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVars.front()->getSourceLocation();
+            m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVar->getName() + "':";
+            m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVar->getSourceLocation();
         }
     }
 
@@ -1194,10 +1197,8 @@ void TypeChecker::postNodeVisit(AST::DeclarationNode *declarationNode) {
             m_semaAnalyzer.getEvent(id).EventLoc() = declarationNode->getSourceLocation();
         } else {
             // Firstly, check for Write-Only
-            WriteOnlyFinder writeOnlyFinder;
-            initExpr->visit(writeOnlyFinder);
-            const std::vector<const AST::VariableNode *> &writeOnlyVars = writeOnlyFinder.getWriteOnlyVars();
-            if(!writeOnlyVars.empty()) {
+            const AST::VariableNode *writeOnlyVar = initExpr->getFirstWriteOnlyVariable();
+            if(writeOnlyVar != nullptr) {
                 std::stringstream ss;
                 ss << "Variable declaration of '" << declarationNode->getQualifierString() << AST::getTypeString(lhsDataType) << " " << declarationNode->getName() <<
                     "' at " << declarationNode->getSourceLocationString()  << ", is initialized to a write-only Result type at " <<
@@ -1208,8 +1209,8 @@ void TypeChecker::postNodeVisit(AST::DeclarationNode *declarationNode) {
                 m_semaAnalyzer.getEvent(id).EventLoc() = declarationNode->getSourceLocation();
 
                 m_semaAnalyzer.getEvent(id).setUsingReference(true);
-                m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVars.front()->getName() + "':";
-                m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVars.front()->getSourceLocation();
+                m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVar->getName() + "':";
+                m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVar->getSourceLocation();
             }
 
             // Secondly, Type check
@@ -1232,32 +1233,46 @@ void TypeChecker::postNodeVisit(AST::IfStatementNode *ifStatementNode) {
      * The expression that determines which branch of an if statement should be taken must
      * have the type bool (not bvec).
      */
-    AST::ExpressionNode *cond = ifStatementNode->getConditionExpression();
+    checkConditionExpression(ifStatementNode, ifStatementNode->getConditionExpression(), "If");
+
+    m_ifScopeCount--;
+    assert(m_ifScopeCount >= 0);
+}
+
+void TypeChecker::postNodeVisit(AST::WhileStatementNode *whileStatementNode) {
+    /*
+     * Same as the condition of an if statement, it is evaluated before every iteration.
+     */
+    checkConditionExpression(whileStatementNode, whileStatementNode->getConditionExpression(), "While");
+
+    m_whileScopeCount--;
+    assert(m_whileScopeCount >= 0);
+}
+
+void TypeChecker::checkConditionExpression(AST::StatementNode *statementNode, AST::ExpressionNode *cond, const std::string &statementKind) {
     int condExprType = cond->getExpressionType();
 
     // Firstly, check for Write-Only for condition expression
     if(condExprType != ANY_TYPE) {
-        WriteOnlyFinder writeOnlyFinder;
-        cond->visit(writeOnlyFinder);
-        const std::vector<const AST::VariableNode *> &writeOnlyVars = writeOnlyFinder.getWriteOnlyVars();
-        if(!writeOnlyVars.empty()) {
+        const AST::VariableNode *writeOnlyVar = cond->getFirstWriteOnlyVariable();
+        if(writeOnlyVar != nullptr) {
             std::stringstream ss;
-            ss << "If-statement condition expression has write-only Result type at " <<
+            ss << statementKind << "-statement condition expression has write-only Result type at " <<
                 cond->getSourceLocationString() << ".";
 
-            auto id = m_semaAnalyzer.createEvent(ifStatementNode, SemanticAnalyzer::EventType::Error);
+            auto id = m_semaAnalyzer.createEvent(statementNode, SemanticAnalyzer::EventType::Error);
             m_semaAnalyzer.getEvent(id).Message() = std::move(ss.str());
             m_semaAnalyzer.getEvent(id).EventLoc() = cond->getSourceLocation();
 
             m_semaAnalyzer.getEvent(id).setUsingReference(true);
-            m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVars.front()->getName() + "':";
-            m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVars.front()->getSourceLocation();
+            m_semaAnalyzer.getEvent(id).RefMessage() = "The first write-only Result variable is '" + writeOnlyVar->getName() + "':";
+            m_semaAnalyzer.getEvent(id).RefLoc() = writeOnlyVar->getSourceLocation();
         }
     }
 
     if(condExprType != BOOL_T) {
         std::stringstream ss;
-        ss << "If-statement condition expression has ";
+        ss << statementKind << "-statement condition expression has ";
         if(condExprType == ANY_TYPE) {
             ss << "unknown type ";
         } else {
@@ -1265,13 +1280,10 @@ void TypeChecker::postNodeVisit(AST::IfStatementNode *ifStatementNode) {
         }
         ss << "at " << cond->getSourceLocationString() << ". Expecting type 'bool'.";
 
-        auto id = m_semaAnalyzer.createEvent(ifStatementNode, SemanticAnalyzer::EventType::Error);
+        auto id = m_semaAnalyzer.createEvent(statementNode, SemanticAnalyzer::EventType::Error);
         m_semaAnalyzer.getEvent(id).Message() = std::move(ss.str());
         m_semaAnalyzer.getEvent(id).EventLoc() = cond->getSourceLocation();
     }
-
-    m_ifScopeCount--;
-    assert(m_ifScopeCount >= 0);
 }
 
 void TypeChecker::postNodeVisit(AST::AssignmentNode *assignmentNode) {
@@ -1342,10 +1354,11 @@ void TypeChecker::postNodeVisit(AST::AssignmentNode *assignmentNode) {
         }
 
         // Secondly, check whether lhs is Write-Only and is not in if-else-statement scope
-        if(m_ifScopeCount > 0 && lhsVar->isWriteOnly()) {
+        if((m_ifScopeCount > 0 || m_whileScopeCount > 0) && lhsVar->isWriteOnly()) {
             std::stringstream ss;
             ss << "Invalid variable assignment for Write-Only Result variable '"<< lhsVar->getName() <<
-                "' in the scope of an if or else statement at " << assignmentNode->getSourceLocationString() << ".";
+                "' in the scope of " << ((m_whileScopeCount > 0) ? "a while" : "an if or else") <<
+                " statement at " << assignmentNode->getSourceLocationString() << ".";
             
             auto id = m_semaAnalyzer.createEvent(assignmentNode, SemanticAnalyzer::EventType::Error);
             m_semaAnalyzer.getEvent(id).Message() = std::move(ss.str());
@@ -1717,58 +1730,22 @@ int TypeChecker::inferDataType(int op, int lhsDataType, int rhsDataType) {
     return ANY_TYPE;
 }
 
-class DataContainer {
-    private:
-        const int m_type;
-    private:
-        const int m_typeBase;
-        const int m_typeOrder;
-        union ValueUnion {
-            std::array<int, 4> intVal;
-            std::array<float, 4> floatVal;
-            std::array<bool, 4> boolVal;
-        } m_value = {0};
-    public:
-        using IntArrayCIt = std::array<int, 4>::const_iterator;
-        using FloatArrayCIt = std::array<float, 4>::const_iterator;
-        using BoolArrayCIt = std::array<bool, 4>::const_iterator;
+DataContainer::DataContainer(int type):
+    m_type(type), m_typeBase(getDataTypeBaseType(m_type)), m_typeOrder(getDataTypeOrder(m_type)) {}
 
-    public:
-        DataContainer(int type):
-            m_type(type), m_typeBase(getDataTypeBaseType(m_type)), m_typeOrder(getDataTypeOrder(m_type)) {}
-        DataContainer(const DataContainer& other):
-            m_type(other.m_type), m_typeBase(other.m_typeBase), m_typeOrder(other.m_typeOrder), m_value(other.m_value) {}
-    
-    public:
-        int getType() const { return m_type; }
-        int getTypeBase() const { return m_typeBase; }
-        int getTypeOrder() const { return m_typeOrder; }
-
-    public:
-        std::array<int, 4> &getIntVal() { assert(m_typeBase == INT_T); return m_value.intVal; }
-        std::array<float, 4> &getFloatVal() { assert(m_typeBase == FLOAT_T); return m_value.floatVal; }
-        std::array<bool, 4> &getBoolVal() { assert(m_typeBase == BOOL_T); return m_value.boolVal; }
-        const std::array<int, 4> &getIntVal() const { assert(m_typeBase == INT_T); return m_value.intVal; }
-        const std::array<float, 4> &getFloatVal() const { assert(m_typeBase == FLOAT_T); return m_value.floatVal; }
-        const std::array<bool, 4> &getBoolVal() const { assert(m_typeBase == BOOL_T); return m_value.boolVal; }
+std::array<int, 4> &DataContainer::getIntVal() { assert(m_typeBase == INT_T); return m_value.intVal; }
+std::array<float, 4> &DataContainer::getFloatVal() { assert(m_typeBase == FLOAT_T); return m_value.floatVal; }
+std::array<bool, 4> &DataContainer::getBoolVal() { assert(m_typeBase == BOOL_T); return m_value.boolVal; }
+const std::array<int, 4> &DataContainer::getIntVal() const { assert(m_typeBase == INT_T); return m_value.intVal; }
+const std::array<float, 4> &DataContainer::getFloatVal() const { assert(m_typeBase == FLOAT_T); return m_value.floatVal; }
+const std::array<bool, 4> &DataContainer::getBoolVal() const { assert(m_typeBase == BOOL_T); return m_value.boolVal; }
 
-    public:
-        IntArrayCIt getIntValBegin() const { assert(m_typeBase == INT_T); return m_value.intVal.begin(); }
-        FloatArrayCIt getFloatValBegin() const { assert(m_typeBase == FLOAT_T); return m_value.floatVal.begin(); }
-        BoolArrayCIt getBoolValBegin() const { assert(m_typeBase == BOOL_T); return m_value.boolVal.begin(); }
-        IntArrayCIt getIntValEnd() const { assert(m_typeBase == INT_T); return m_value.intVal.begin() + m_typeOrder; }
-        FloatArrayCIt getFloatValEnd() const { assert(m_typeBase == FLOAT_T); return m_value.floatVal.begin() + m_typeOrder; }
-        BoolArrayCIt getBoolValEnd() const { assert(m_typeBase == BOOL_T); return m_value.boolVal.begin() + m_typeOrder; }
-
-    public:
-        DataContainer& operator= (const DataContainer &rhs);
-    
-    public:
-        DataContainer getSlice(int idx);
-
-    public:
-        AST::ExpressionNode *createASTExpr() const;
-};
+DataContainer::IntArrayCIt DataContainer::getIntValBegin() const { assert(m_typeBase == INT_T); return m_value.intVal.begin(); }
+DataContainer::FloatArrayCIt DataContainer::getFloatValBegin() const { assert(m_typeBase == FLOAT_T); return m_value.floatVal.begin(); }
+DataContainer::BoolArrayCIt DataContainer::getBoolValBegin() const { assert(m_typeBase == BOOL_T); return m_value.boolVal.begin(); }
+DataContainer::IntArrayCIt DataContainer::getIntValEnd() const { assert(m_typeBase == INT_T); return m_value.intVal.begin() + m_typeOrder; }
+DataContainer::FloatArrayCIt DataContainer::getFloatValEnd() const { assert(m_typeBase == FLOAT_T); return m_value.floatVal.begin() + m_typeOrder; }
+DataContainer::BoolArrayCIt DataContainer::getBoolValEnd() const { assert(m_typeBase == BOOL_T); return m_value.boolVal.begin() + m_typeOrder; }
 
 DataContainer operator+(const DataContainer &lhs, const DataContainer &rhs) {
     /*
@@ -2397,6 +2374,11 @@ class ConstantExpressionEvaluator: public AST::Visitor {
                         m_data = lhsData * rhsData;
                         break;
                     case SLASH:
+                        /* Integer division by zero is left to run time */
+                        if(rhsData.getTypeBase() == INT_T && rhsData.getIntVal()[0] == 0) {
+                            m_evaluationSuccessful = false;
+                            break;
+                        }
                         m_data = lhsData / rhsData;
                         break;
                     case EXP:
@@ -2494,7 +2476,7 @@ class ConstantExpressionEvaluator: public AST::Visitor {
             assert(m_data.getType() == constructorNode->getExpressionType());
 
             const AST::ExpressionsNode *exprs = constructorNode->getArgumentExpressions();
-            const std::vector<AST::ExpressionNode *> &args = exprs->getExpressionList();
+            const AST::ExpressionList &args = exprs->getExpressionList();
 
             int constructorDataType = constructorNode->getConstructorType();
             int constructorDataTypeBaseType = getDataTypeBaseType(constructorDataType);
@@ -2530,10 +2512,19 @@ class ConstantExpressionEvaluator: public AST::Visitor {
             ConstantExpressionEvaluator ev(data);
             expr->visit(ev);
 
+            /* NaN and infinity have no ARB representation, leave them to run time like IR::foldConstants does */
+            if(ev.m_evaluationSuccessful && data.getTypeBase() == FLOAT_T) {
+                return std::all_of(data.getFloatValBegin(), data.getFloatValEnd(), [](float a) { return std::isfinite(a); });
+            }
+
             return ev.m_evaluationSuccessful;
         }
 };
 
+bool evaluateConstantExpression(AST::ExpressionNode *expr, DataContainer &data) {
+    return ConstantExpressionEvaluator::evaluateValue(expr, data);
+}
+
 class ConstantDeclarationOptimizer: public AST::Visitor {
     private:
         virtual void preNodeVisit(AST::DeclarationNode *declarationNode);
@@ -2687,6 +2678,7 @@ class VariableAssignmentChecker: public AST::Visitor {
     private:
         virtual void nodeVisit(AST::AssignmentNode *assignmentNode);
         virtual void nodeVisit(AST::IfStatementNode *ifStatementNode);
+        virtual void nodeVisit(AST::WhileStatementNode *whileStatementNode);
         virtual void nodeVisit(AST::ScopeNode *scopeNode);
 };
 
@@ -2819,6 +2811,38 @@ void VariableAssignmentChecker::nodeVisit(AST::IfStatementNode *ifStatementNode)
     m_currentFlowEdge = commonParentEdge;
 }
 
+void VariableAssignmentChecker::nodeVisit(AST::WhileStatementNode *whileStatementNode) {
+    AST::ExpressionNode *cond = whileStatementNode->getConditionExpression();
+    cond->visit(*this);
+
+    VariableAssignmentLog *commonParentEdge = m_currentFlowEdge;
+
+    // Branch, the body may run zero times
+    std::unique_ptr<VariableAssignmentLog> bodyStmtEdge(new VariableAssignmentLog(commonParentEdge));
+    m_currentFlowEdge = bodyStmtEdge.get();
+    whileStatementNode->getBodyStatement()->visit(*this);
+
+    std::unique_ptr<VariableAssignmentLog> skipEdge(new VariableAssignmentLog(commonParentEdge));
+
+    // If the body always runs at least once
+    bool isAlwaysEntered = false;
+    if(cond->isConst() && cond->getExpressionType() == BOOL_T) {
+        DataContainer condData(BOOL_T);
+        bool successful = ConstantExpressionEvaluator::evaluateValue(cond, condData);
+
+        isAlwaysEntered = successful && condData.getBoolVal()[0];
+    }
+
+    // Merge
+    if(isAlwaysEntered) {
+        commonParentEdge->merge(*bodyStmtEdge);
+    } else {
+        commonParentEdge->merge(*bodyStmtEdge, *skipEdge);
+    }
+
+    m_currentFlowEdge = commonParentEdge;
+}
+
 void VariableAssignmentChecker::nodeVisit(AST::ScopeNode *scopeNode) {
     std::unique_ptr<VariableAssignmentLog> rootEdge(new VariableAssignmentLog(nullptr));
     m_currentFlowEdge = rootEdge.get();
@@ -2829,6 +2853,299 @@ void VariableAssignmentChecker::nodeVisit(AST::ScopeNode *scopeNode) {
     m_currentFlowEdge = nullptr;
 }
 
+/*
+ * Rewrites algebraic identities in place, children before their parents:
+ *   x*1, 1*x, x/1, x^1, x+0, 0+x, x-0          -> x
+ *   --x, !!b                                   -> x, b
+ *   b&&true, b||false, b&&b, b||b (any side)   -> b
+ *   b&&false, b||true (any side)               -> false, true
+ *   x-x                                        -> 0
+ *   x==x, x<=x, x>=x                           -> true
+ *   x!=x, x<x, x>x                             -> false
+ * Expressions have no side effect, so dropping an operand is always safe.
+ * Remaining sub-expressions are moved rather than copied, their declaration links stay valid.
+ */
+class AlgebraicSimplifier: public AST::Visitor {
+    private:
+        virtual void postNodeVisit(AST::ExpressionsNode *expressionsNode);
+        virtual void postNodeVisit(AST::UnaryExpressionNode *unaryExpressionNode);
+        virtual void postNodeVisit(AST::BinaryExpressionNode *binaryExpressionNode);
+        virtual void postNodeVisit(AST::DeclarationNode *declarationNode);
+        virtual void postNodeVisit(AST::IfStatementNode *ifStatementNode);
+        virtual void postNodeVisit(AST::WhileStatementNode *whileStatementNode);
+        virtual void postNodeVisit(AST::AssignmentNode *assignmentNode);
+
+    private:
+        /* Returns the replacement of expr, expr itself is destructed if replaced */
+        static AST::ExpressionNode *simplify(AST::ExpressionNode *expr);
+        static AST::ExpressionNode *simplifyUnary(AST::UnaryExpressionNode *unaryExpressionNode);
+        static AST::ExpressionNode *simplifyBinary(AST::BinaryExpressionNode *binaryExpressionNode);
+
+    private:
+        /* Whether expr is a compile-time constant with every component equal to val, true and false are 1 and 0 */
+        static bool isConstantSplat(AST::ExpressionNode *expr, float val);
+        static bool isSameExpression(const AST::ExpressionNode *lhs, const AST::ExpressionNode *rhs);
+        static bool isSameExpressions(const AST::ExpressionsNode *lhs, const AST::ExpressionsNode *rhs);
+};
+
+void AlgebraicSimplifier::postNodeVisit(AST::ExpressionsNode *expressionsNode) {
+    for(unsigned idx = 0; idx < expressionsNode->getNumberExpression(); idx++) {
+        expressionsNode->setExpressionAt(idx, simplify(expressionsNode->getExpressionAt(idx)));
+    }
+}
+
+void AlgebraicSimplifier::postNodeVisit(AST::UnaryExpressionNode *unaryExpressionNode) {
+    unaryExpressionNode->setExpression(simplify(unaryExpressionNode->getExpression()));
+}
+
+void AlgebraicSimplifier::postNodeVisit(AST::BinaryExpressionNode *binaryExpressionNode) {
+    binaryExpressionNode->setLeftExpression(simplify(binaryExpressionNode->getLeftExpression()));
+    binaryExpressionNode->setRightExpression(simplify(binaryExpressionNode->getRightExpression()));
+}
+
+void AlgebraicSimplifier::postNodeVisit(AST::DeclarationNode *declarationNode) {
+    if(declarationNode->getExpression() != nullptr) {
+        declarationNode->setExpression(simplify(declarationNode->getExpression()));
+    }
+}
+
+void AlgebraicSimplifier::postNodeVisit(AST::IfStatementNode *ifStatementNode) {
+    ifStatementNode->setConditionExpression(simplify(ifStatementNode->getConditionExpression()));
+}
+
+void AlgebraicSimplifier::postNodeVisit(AST::WhileStatementNode *whileStatementNode) {
+    whileStatementNode->setConditionExpression(simplify(whileStatementNode->getConditionExpression()));
+}
+
+void AlgebraicSimplifier::postNodeVisit(AST::AssignmentNode *assignmentNode) {
+    assignmentNode->setExpression(simplify(assignmentNode->getExpression()));
+}
+
+AST::ExpressionNode *AlgebraicSimplifier::simplify(AST::ExpressionNode *expr) {
+    if(expr->getExpressionType() == ANY_TYPE) {
+        return expr;
+    }
+
+    if(AST::UnaryExpressionNode *unaryExpressionNode = dynamic_cast<AST::UnaryExpressionNode *>(expr)) {
+        return simplifyUnary(unaryExpressionNode);
+    }
+    if(AST::BinaryExpressionNode *binaryExpressionNode = dynamic_cast<AST::BinaryExpressionNode *>(expr)) {
+        return simplifyBinary(binaryExpressionNode);
+    }
+    return expr;
+}
+
+AST::ExpressionNode *AlgebraicSimplifier::simplifyUnary(AST::UnaryExpressionNode *unaryExpressionNode) {
+    AST::UnaryExpressionNode *innerExpr = dynamic_cast<AST::UnaryExpressionNode *>(unaryExpressionNode->getExpression());
+    if(innerExpr == nullptr || innerExpr->getOperator() != unaryExpressionNode->getOperator()) {
+        return unaryExpressionNode;
+    }
+
+    /* --x, !!b */
+    AST::ExpressionNode *resultExpr = innerExpr->getExpression();
+    innerExpr->setExpression(nullptr);
+    AST::ASTNode::destructNode(unaryExpressionNode);
+
+    return resultExpr;
+}
+
+AST::ExpressionNode *AlgebraicSimplifier::simplifyBinary(AST::BinaryExpressionNode *binaryExpressionNode) {
+    int dataType = binaryExpressionNode->getExpressionType();
+    AST::ExpressionNode *lhsExpr = binaryExpressionNode->getLeftExpression();
+    AST::ExpressionNode *rhsExpr = binaryExpressionNode->getRightExpression();
+
+    /* Keeps one operand in place of the expression, only if it already has the type of the expression */
+    auto keepOperand = [binaryExpressionNode, dataType](AST::ExpressionNode *operandExpr) -> AST::ExpressionNode * {
+        if(operandExpr->getExpressionType() != dataType) {
+            return nullptr;
+        }
+        if(operandExpr == binaryExpressionNode->getLeftExpression()) {
+            binaryExpressionNode->setLeftExpression(nullptr);
+        } else {
+            binaryExpressionNode->setRightExpression(nullptr);
+        }
+        AST::ASTNode::destructNode(binaryExpressionNode);
+        return operandExpr;
+    };
+
+    /* Replaces the expression with a constant of its type, with every component set to val */
+    auto replaceWithConstant = [binaryExpressionNode, dataType](bool val) -> AST::ExpressionNode * {
+        DataContainer resultData(dataType);
+        for(int i = 0; i < resultData.getTypeOrder(); i++) {
+            switch(resultData.getTypeBase()) {
+                case INT_T:
+                    resultData.getIntVal()[i] = val ? 1 : 0;
+                    break;
+                case FLOAT_T:
+                    resultData.getFloatVal()[i] = val ? 1.0f : 0.0f;
+                    break;
+                case BOOL_T:
+                    resultData.getBoolVal()[i] = val;
+                    break;
+                default:
+                    assert(0);
+            }
+        }
+
+        AST::ExpressionNode *resultExpr = resultData.createASTExpr();
+        resultExpr->setSourceLocation(binaryExpressionNode->getSourceLocation());
+        AST::ASTNode::destructNode(binaryExpressionNode);
+        return resultExpr;
+    };
+
+    AST::ExpressionNode *resultExpr = nullptr;
+    switch(binaryExpressionNode->getOperator()) {
+        case PLUS:
+            if(isConstantSplat(rhsExpr, 0.0f)) {
+                resultExpr = keepOperand(lhsExpr);
+            }
+            if(resultExpr == nullptr && isConstantSplat(lhsExpr, 0.0f)) {
+                resultExpr = keepOperand(rhsExpr);
+            }
+            break;
+        case MINUS:
+            if(isConstantSplat(rhsExpr, 0.0f)) {
+                resultExpr = keepOperand(lhsExpr);
+            }
+            if(resultExpr == nullptr && isSameExpression(lhsExpr, rhsExpr)) {
+                resultExpr = replaceWithConstant(false);
+            }
+            break;
+        case TIMES:
+            if(isConstantSplat(rhsExpr, 1.0f)) {
+                resultExpr = keepOperand(lhsExpr);
+            }
+            if(resultExpr == nullptr && isConstantSplat(lhsExpr, 1.0f)) {
+                resultExpr = keepOperand(rhsExpr);
+            }
+            break;
+        case SLASH:
+        case EXP:
+            if(isConstantSplat(rhsExpr, 1.0f)) {
+                resultExpr = keepOperand(lhsExpr);
+            }
+            break;
+        case AND:
+        case OR: {
+            /* Identity of && is true, of || is false; the other one absorbs */
+            float identity = binaryExpressionNode->getOperator() == AND ? 1.0f : 0.0f;
+            if(isConstantSplat(rhsExpr, identity) || isSameExpression(lhsExpr, rhsExpr)) {
+                resultExpr = keepOperand(lhsExpr);
+            } else if(isConstantSplat(lhsExpr, identity)) {
+                resultExpr = keepOperand(rhsExpr);
+            } else if(isConstantSplat(lhsExpr, 1.0f - identity) || isConstantSplat(rhsExpr, 1.0f - identity)) {
+                resultExpr = replaceWithConstant(identity == 0.0f);
+            }
+            break;
+        }
+        case EQL:
+        case LEQ:
+        case GEQ:
+            if(isSameExpression(lhsExpr, rhsExpr)) {
+                resultExpr = replaceWithConstant(true);
+            }
+            break;
+        case NEQ:
+        case LSS:
+        case GTR:
+            if(isSameExpression(lhsExpr, rhsExpr)) {
+                resultExpr = replaceWithConstant(false);
+            }
+            break;
+        default:
+            break;
+    }
+
+    return resultExpr != nullptr ? resultExpr : binaryExpressionNode;
+}
+
+bool AlgebraicSimplifier::isConstantSplat(AST::ExpressionNode *expr, float val) {
+    /* Uniforms are const qualified but not known at compile time, the evaluation rejects them */
+    if(!expr->isConst() || expr->getExpressionType() == ANY_TYPE) {
+        return false;
+    }
+
+    DataContainer data(expr->getExpressionType());
+    if(!evaluateConstantExpression(expr, data)) {
+        return false;
+    }
+
+    switch(data.getTypeBase()) {
+        case INT_T:
+            return std::all_of(data.getIntValBegin(), data.getIntValEnd(), [val](int a) { return a == val; });
+        case FLOAT_T:
+            return std::all_of(data.getFloatValBegin(), data.getFloatValEnd(), [val](float a) { return a == val; });
+        case BOOL_T:
+            return std::all_of(data.getBoolValBegin(), data.getBoolValEnd(), [val](bool a) { return a == (val != 0.0f); });
+        default:
+            assert(0);
+    }
+    return false;
+}
+
+bool AlgebraicSimplifier::isSameExpression(const AST::ExpressionNode *lhs, const AST::ExpressionNode *rhs) {
+    if(lhs->getExpressionType() != rhs->getExpressionType()) {
+        return false;
+    }
+
+    if(const AST::IdentifierNode *lhsIdent = dynamic_cast<const AST::IdentifierNode *>(lhs)) {
+        const AST::IdentifierNode *rhsIdent = dynamic_cast<const AST::IdentifierNode *>(rhs);
+        return rhsIdent != nullptr && lhsIdent->getDeclaration() != nullptr && 
+            lhsIdent->getDeclaration() == rhsIdent->getDeclaration();
+    }
+    if(const AST::IndexingNode *lhsIndexing = dynamic_cast<const AST::IndexingNode *>(lhs)) {
+        const AST::IndexingNode *rhsIndexing = dynamic_cast<const AST::IndexingNode *>(rhs);
+        return rhsIndexing != nullptr && isSameExpression(lhsIndexing->getIdentifier(), rhsIndexing->getIdentifier()) &&
+            isSameExpression(lhsIndexing->getIndexExpression(), rhsIndexing->getIndexExpression());
+    }
+    if(const AST::IntLiteralNode *lhsLit = dynamic_cast<const AST::IntLiteralNode *>(lhs)) {
+        const AST::IntLiteralNode *rhsLit = dynamic_cast<const AST::IntLiteralNode *>(rhs);
+        return rhsLit != nullptr && lhsLit->getVal() == rhsLit->getVal();
+    }
+    if(const AST::FloatLiteralNode *lhsLit = dynamic_cast<const AST::FloatLiteralNode *>(lhs)) {
+        const AST::FloatLiteralNode *rhsLit = dynamic_cast<const AST::FloatLiteralNode *>(rhs);
+        return rhsLit != nullptr && lhsLit->getVal() == rhsLit->getVal();
+    }
+    if(const AST::BooleanLiteralNode *lhsLit = dynamic_cast<const AST::BooleanLiteralNode *>(lhs)) {
+        const AST::BooleanLiteralNode *rhsLit = dynamic_cast<const AST::BooleanLiteralNode *>(rhs);
+        return rhsLit != nullptr && lhsLit->getVal() == rhsLit->getVal();
+    }
+    if(const AST::UnaryExpressionNode *lhsUnary = dynamic_cast<const AST::UnaryExpressionNode *>(lhs)) {
+        const AST::UnaryExpressionNode *rhsUnary = dynamic_cast<const AST::UnaryExpressionNode *>(rhs);
+        return rhsUnary != nullptr && lhsUnary->getOperator() == rhsUnary->getOperator() &&
+            isSameExpression(lhsUnary->getExpression(), rhsUnary->getExpression());
+    }
+    if(const AST::BinaryExpressionNode *lhsBinary = dynamic_cast<const AST::BinaryExpressionNode *>(lhs)) {
+        const AST::BinaryExpressionNode *rhsBinary = dynamic_cast<const AST::BinaryExpressionNode *>(rhs);
+        return rhsBinary != nullptr && lhsBinary->getOperator() == rhsBinary->getOperator() &&
+            isSameExpression(lhsBinary->getLeftExpression(), rhsBinary->getLeftExpression()) &&
+            isSameExpression(lhsBinary->getRightExpression(), rhsBinary->getRightExpression());
+    }
+    if(const AST::FunctionNode *lhsFunction = dynamic_cast<const AST::FunctionNode *>(lhs)) {
+        const AST::FunctionNode *rhsFunction = dynamic_cast<const AST::FunctionNode *>(rhs);
+        return rhsFunction != nullptr && lhsFunction->getSymbolID() == rhsFunction->getSymbolID() &&
+            isSameExpressions(lhsFunction->getArgumentExpressions(), rhsFunction->getArgumentExpressions());
+    }
+    if(const AST::ConstructorNode *lhsConstructor = dynamic_cast<const AST::ConstructorNode *>(lhs)) {
+        const AST::ConstructorNode *rhsConstructor = dynamic_cast<const AST::ConstructorNode *>(rhs);
+        return rhsConstructor != nullptr && lhsConstructor->getConstructorType() == rhsConstructor->getConstructorType() &&
+            isSameExpressions(lhsConstructor->getArgumentExpressions(), rhsConstructor->getArgumentExpressions());
+    }
+    return false;
+}
+
+bool AlgebraicSimplifier::isSameExpressions(const AST::ExpressionsNode *lhs, const AST::ExpressionsNode *rhs) {
+    if(lhs->getNumberExpression() != rhs->getNumberExpression()) {
+        return false;
+    }
+    for(unsigned idx = 0; idx < lhs->getNumberExpression(); idx++) {
+        if(!isSameExpression(lhs->getExpressionAt(idx), rhs->getExpressionAt(idx))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 } /* END NAMESPACE */
 
 int semantic_check(node * ast) {
@@ -2892,4 +3209,9 @@ int semantic_check(node * ast) {
         // if no error, return 1
         return 1;
     }
+}
+
+void semantic_simplify(node * ast) {
+    SEMA::AlgebraicSimplifier algebraicSimplifier;
+    static_cast<AST::ASTNode *>(ast)->visit(algebraicSimplifier);
 }
\ No newline at end of file
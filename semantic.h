@@ -3,7 +3,11 @@
 
 #include "ast.h"
 
+#include <array>
+
 int semantic_check(node * ast);
+/* Rewrites algebraic identities in place, only for an AST that passed semantic_check */
+void semantic_simplify(node * ast);
 
 namespace SEMA{
 
@@ -15,6 +19,63 @@ enum class DataTypeCategory {
 DataTypeCategory getDataTypeCategory(int dataType);
 int getDataTypeOrder(int dataType);
 int getDataTypeBaseType(int dataType);
+int getDataType(int baseType, int order);
+
+/* Compile-time value of a data type, only the first getTypeOrder() components are valid */
+class DataContainer {
+    private:
+        const int m_type;
+    private:
+        const int m_typeBase;
+        const int m_typeOrder;
+        union ValueUnion {
+            std::array<int, 4> intVal;
+            std::array<float, 4> floatVal;
+            std::array<bool, 4> boolVal;
+        } m_value = {0};
+    public:
+        using IntArrayCIt = std::array<int, 4>::const_iterator;
+        using FloatArrayCIt = std::array<float, 4>::const_iterator;
+        using BoolArrayCIt = std::array<bool, 4>::const_iterator;
+
+    public:
+        DataContainer(int type);
+        DataContainer(const DataContainer& other):
+            m_type(other.m_type), m_typeBase(other.m_typeBase), m_typeOrder(other.m_typeOrder), m_value(other.m_value) {}
+    
+    public:
+        int getType() const { return m_type; }
+        int getTypeBase() const { return m_typeBase; }
+        int getTypeOrder() const { return m_typeOrder; }
+
+    public:
+        std::array<int, 4> &getIntVal();
+        std::array<float, 4> &getFloatVal();
+        std::array<bool, 4> &getBoolVal();
+        const std::array<int, 4> &getIntVal() const;
+        const std::array<float, 4> &getFloatVal() const;
+        const std::array<bool, 4> &getBoolVal() const;
+
+    public:
+        IntArrayCIt getIntValBegin() const;
+        FloatArrayCIt getFloatValBegin() const;
+        BoolArrayCIt getBoolValBegin() const;
+        IntArrayCIt getIntValEnd() const;
+        FloatArrayCIt getFloatValEnd() const;
+        BoolArrayCIt getBoolValEnd() const;
+
+    public:
+        DataContainer& operator= (const DataContainer &rhs);
+    
+    public:
+        DataContainer getSlice(int idx);
+
+    public:
+        AST::ExpressionNode *createASTExpr() const;
+};
+
+/* Evaluates an expression of literals and initialized const qualified variables, false if not possible */
+bool evaluateConstantExpression(AST::ExpressionNode *expr, DataContainer &data);
 
 }
 
@@ -9,16 +9,18 @@ class SymbolNode {
         SymbolNode *m_prevSymbolNode = nullptr;                     // Link to the previous SymbolNode in SymbolTable
         AST::DeclarationNode *m_decl = nullptr;                     // Reference to the DeclarationNode in AST
         bool m_isFirstInScope        = false;                       // Whether this node is the first symbol of a new scope
+        unsigned m_scopeVersion      = 0;                           // Version of the scope declaring this symbol
 
     public:
         SymbolNode() = default;
-        SymbolNode(SymbolNode *prevSymbolNode, AST::DeclarationNode *decl, bool isFirstInScope):
-            m_prevSymbolNode(prevSymbolNode), m_decl(decl), m_isFirstInScope(isFirstInScope) {}
+        SymbolNode(SymbolNode *prevSymbolNode, AST::DeclarationNode *decl, bool isFirstInScope, unsigned scopeVersion):
+            m_prevSymbolNode(prevSymbolNode), m_decl(decl), m_isFirstInScope(isFirstInScope), m_scopeVersion(scopeVersion) {}
     
     public:
         SymbolNode *getPrevSymbolNode() const { return m_prevSymbolNode; }
         AST::DeclarationNode *getDecl() const { return m_decl; }
         bool isFirstInScope() const { return m_isFirstInScope; }
+        unsigned getScopeVersion() const { return m_scopeVersion; }
 };
 
 SymbolTable::SymbolTable() = default;
@@ -30,19 +32,28 @@ void SymbolTable::clear() {
     m_symbolTreeScopeLeaves.clear();
     m_encounterNewScope = false;
     m_currentHead = nullptr;
+    m_scopeVersionCount = 0;
+    m_shadowStacks.clear();
+    m_shadowLog.clear();
     m_positionOfRef.clear();
 }
 
 void SymbolTable::enterScope() {
     /* Push the last symbol (currentHead) of a scope onto the stack */
-    m_scope.push_front(m_currentHead);
+    m_scope.push_front({m_currentHead, ++m_scopeVersionCount, m_shadowLog.size()});
     m_encounterNewScope = true;
 }
 
 void SymbolTable::exitScope() {
+    /* Unshadow the symbols declared in this scope */
+    for(size_t i = m_shadowLog.size(); i > m_scope.front().m_shadowLogSize; i--) {
+        m_shadowStacks[m_shadowLog[i - 1]].pop_back();
+    }
+    m_shadowLog.resize(m_scope.front().m_shadowLogSize);
+
     /* Pop the last symbol of a scope from the stack, and make it the currentHead */
     m_symbolTreeScopeLeaves.push_back(m_currentHead);
-    m_currentHead = m_scope.front();
+    m_currentHead = m_scope.front().m_lastSymbol;
     m_scope.pop_front();
     m_encounterNewScope = false;
 }
@@ -55,9 +66,18 @@ AST::DeclarationNode *SymbolTable::declareSymbol(AST::DeclarationNode *decl) {
         return redecl;
     }
 
-    std::unique_ptr<SymbolNode> uptr(new SymbolNode(m_currentHead, decl, m_encounterNewScope));
+    unsigned scopeVersion = m_scope.empty() ? 0 : m_scope.front().m_version;
+    std::unique_ptr<SymbolNode> uptr(new SymbolNode(m_currentHead, decl, m_encounterNewScope, scopeVersion));
     m_encounterNewScope = false;
     m_currentHead = uptr.get();
+
+    AST::SymbolID name = decl->getSymbolID();
+    if(name >= m_shadowStacks.size()) {
+        m_shadowStacks.resize(name + 1);
+    }
+    m_shadowStacks[name].push_back(uptr.get());
+    m_shadowLog.push_back(name);
+
     m_symbolNodes.push_back(std::move(uptr));
 
     return nullptr;
@@ -66,8 +86,11 @@ AST::DeclarationNode *SymbolTable::declareSymbol(AST::DeclarationNode *decl) {
 void SymbolTable::markSymbolRefPos(AST::IdentifierNode *ident) {
     assert(ident != nullptr);
 
+    /* Symbols visible now are exactly the ones visible from this position later on */
+    SymbolNode *symNode = findVisibleSymbol(ident->getSymbolID());
+
     assert(m_positionOfRef.count(ident) == 0);
-    m_positionOfRef.emplace(ident, m_currentHead);
+    m_positionOfRef.emplace(ident, SymbolReference{m_currentHead, symNode ? symNode->getDecl() : nullptr});
 }
 
 AST::DeclarationNode *SymbolTable::getSymbolDecl(AST::IdentifierNode *ident) const {
@@ -75,41 +98,15 @@ AST::DeclarationNode *SymbolTable::getSymbolDecl(AST::IdentifierNode *ident) con
 
     assert(m_positionOfRef.count(ident) == 1);
 
-    SymbolNode *symNode = m_positionOfRef.at(ident);
-    AST::DeclarationNode *resultDecl = nullptr;
-
-    while(symNode != nullptr) {
-        AST::DeclarationNode *decl = symNode->getDecl();
-        if(checkSymbolMatch(decl, ident)) {
-            resultDecl = decl;
-            break;
-        }
-
-        symNode = symNode->getPrevSymbolNode();
-    }
-
-    return resultDecl;
+    return m_positionOfRef.at(ident).m_decl;
 }
 
 AST::DeclarationNode *SymbolTable::findAnyRedeclaration(AST::DeclarationNode *decl) const {
     assert(decl != nullptr);
 
-    SymbolNode *symNode = m_currentHead;
-
-    AST::DeclarationNode *redecl = nullptr;
+    SymbolNode *symNode = findVisibleSymbol(decl->getSymbolID());
 
-    while(symNode != nullptr) {
-        AST::DeclarationNode *curDecl = symNode->getDecl();
-
-        if(curDecl->getName() == decl->getName()) {
-            redecl = curDecl;
-            break;
-        }
-
-        symNode = symNode->getPrevSymbolNode();
-    }
-
-    return redecl;
+    return symNode ? symNode->getDecl() : nullptr;
 }
 
 int SymbolTable::printSymbolTreeTo(SymbolNode *node, const AST::DeclarationNode *markDecl) const {
@@ -158,7 +155,7 @@ void SymbolTable::printSymbolReference() const {
         fprintf(m_out, "========================================\n");
         fprintf(m_out, "Root\n");
         AST::IdentifierNode *identNode = idSymPair.first;
-        int scopeCount = printSymbolTreeTo(idSymPair.second, identNode->getDeclaration());
+        int scopeCount = printSymbolTreeTo(idSymPair.second.m_position, identNode->getDeclaration());
         fprintf(m_out, "%s", std::string(scopeCount * 3, ' ').c_str());
         fprintf(m_out, "   `==>");
         fprintf(m_out, "Ref[%d]: ", i);
@@ -171,27 +168,22 @@ void SymbolTable::printSymbolReference() const {
 }
 
 AST::DeclarationNode *SymbolTable::findRedeclaration(AST::DeclarationNode *decl) const {
-    SymbolNode *scopeEnd = m_scope.front();
-    SymbolNode *symNode = m_currentHead;
-
-    AST::DeclarationNode *redecl = nullptr;
+    SymbolNode *symNode = findVisibleSymbol(decl->getSymbolID());
 
-    while(symNode != scopeEnd) {
-        AST::DeclarationNode *curDecl = symNode->getDecl();
-
-        if(curDecl->getName() == decl->getName()) {
-            redecl = curDecl;
-            break;
-        }
-
-        symNode = symNode->getPrevSymbolNode();
+    /* Only a redeclaration if the innermost one is from the current scope */
+    if(symNode != nullptr && !m_scope.empty() && symNode->getScopeVersion() == m_scope.front().m_version) {
+        return symNode->getDecl();
     }
 
-    return redecl;
+    return nullptr;
 }
 
-bool SymbolTable::checkSymbolMatch(AST::DeclarationNode *decl, AST::IdentifierNode *ident) {
-    return (ident->getName() == decl->getName());
+SymbolNode *SymbolTable::findVisibleSymbol(AST::SymbolID name) const {
+    if(name >= m_shadowStacks.size() || m_shadowStacks[name].empty()) {
+        return nullptr;
+    }
+
+    return m_shadowStacks[name].back();
 }
 
 } /* END NAMESPACE */
\ No newline at end of file
@@ -13,15 +13,29 @@ namespace ST{
 class SymbolNode;
 
 class SymbolTable {
+    private:
+        struct Scope {
+            SymbolNode *m_lastSymbol;                               // currentHead when entering this scope
+            unsigned m_version;                                     // Unique among all scopes entered
+            size_t m_shadowLogSize;                                 // Size of m_shadowLog when entering this scope
+        };
+        struct SymbolReference {
+            SymbolNode *m_position;                                 // currentHead at the reference
+            AST::DeclarationNode *m_decl;                           // Declaration visible at the reference
+        };
     private:
         std::vector<std::unique_ptr<SymbolNode>> m_symbolNodes;     // Ownership of all SymbolNodes
     private:
-        std::forward_list<SymbolNode *> m_scope;                    // Scopes
+        std::forward_list<Scope> m_scope;                           // Scopes
         std::vector<SymbolNode *> m_symbolTreeScopeLeaves;          // Symbol Tree Scope Leaves
         bool m_encounterNewScope = false;                           // Scope flag
         SymbolNode *m_currentHead = nullptr;                        // Current SymbolNode
+        unsigned m_scopeVersionCount = 0;                           // Number of scopes entered
+    private:
+        std::vector<std::vector<SymbolNode *>> m_shadowStacks;      // Visible SymbolNodes of each SymbolID, innermost last
+        std::vector<AST::SymbolID> m_shadowLog;                     // SymbolID of each push onto m_shadowStacks
     private:
-        std::unordered_map<AST::IdentifierNode *, SymbolNode *> m_positionOfRef;
+        std::unordered_map<AST::IdentifierNode *, SymbolReference> m_positionOfRef;
                                                                     // Position of reference of Identifier
     private:
         FILE *m_out = stdout;
@@ -55,7 +69,8 @@ class SymbolTable {
         /* Helper Functions */
         /* Return redecl if redeclaration under current scope; otherwise nullptr */
         AST::DeclarationNode *findRedeclaration(AST::DeclarationNode *decl) const;
-        static bool checkSymbolMatch(AST::DeclarationNode *decl, AST::IdentifierNode *ident);
+        /* Return the innermost visible SymbolNode named name; otherwise nullptr */
+        SymbolNode *findVisibleSymbol(AST::SymbolID name) const;
         int printSymbolTreeTo(SymbolNode *node, const AST::DeclarationNode *markDecl = nullptr) const;
 };
 
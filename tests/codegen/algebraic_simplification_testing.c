@@ -0,0 +1,14 @@
+{
+    const float one = 1.0;
+    vec4 color = gl_Color * one + vec4(0.0, 0.0, 0.0, 0.0);
+    float x = --gl_TexCoord[0] - 0.0;
+    bool inside = !!(x < gl_TexCoord[1]) && true;
+    bool twice = inside || inside;
+    if(twice && x >= x) {
+        color = color - color + gl_Secondary;
+    }
+    if(x != x || false) {
+        color = gl_Color;
+    }
+    gl_FragColor = color * (x / 1.0);
+}
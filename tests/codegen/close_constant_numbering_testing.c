@@ -0,0 +1,6 @@
+{
+    vec4 a = gl_Color * 1.0000001;
+    vec4 b = gl_Color * 1.0000002;
+    vec4 c = gl_Color * 1.0000001;
+    gl_FragColor = (a - b) + c;
+}
@@ -0,0 +1,23 @@
+{
+    vec4 color = gl_Color;
+    bool useTexture = false;
+    float gain = 2.0;
+    if(true) {
+        color = color * gain;
+    }
+    if(useTexture) {
+        color = gl_TexCoord;
+    } else {
+        if(gain > 1.0) {
+            gain = gain * 0.5;
+            color[3] = gain;
+        }
+        if(color[0] > 0.5) {
+            color = color + gl_TexCoord;
+        }
+    }
+    if(false) {
+        color = vec4(0.0, 0.0, 0.0, 0.0);
+    }
+    gl_FragColor = color;
+}
@@ -0,0 +1,15 @@
+{
+    const float degree = 2.0 * 3.14159 / 180.0;
+    const vec4 offset = vec4(1.0, 2.0, 3.0, 4.0);
+    vec4 color = gl_Color;
+    float angle = gl_TexCoord[0] * degree;
+    bool flag = !(1 > 2) && true;
+    int count = 7 / 2 + 1;
+    ivec2 counts = ivec2(count, 1);
+    color = color * (offset - vec4(0.5, 0.5, 0.5, 0.5)) * (offset[2] * 2.0);
+    if(flag) {
+        color[0] = angle * -degree;
+    }
+    color[1] = color[1] * 2.0;
+    gl_FragColor = color;
+}
@@ -0,0 +1,14 @@
+{
+    const float scale = 0.5;
+    const vec3 weights = vec3(0.25, 0.5, 0.75);
+    vec4 color = gl_Color;
+    vec3 tint = vec3(color[0], color[1], color[2]);
+    float luma = dp3(tint, weights);
+    if(luma > scale) {
+        color = color * vec4(0.5, 0.5, 0.5, 1.0);
+    } else {
+        color = color + vec4(0.25, 0.75, 2.0, 0.0);
+    }
+    color[3] = luma * 2.0 + 1.0;
+    gl_FragColor = color;
+}
@@ -0,0 +1,17 @@
+{
+    const vec4 colorUnused = vec4(1.0, 2.0, 3.0, 4.0);
+    vec4 colora = gl_Color;
+    vec4 colorb = gl_TexCoord;
+    float floata = dp3(colora, colorb);
+    float floatb = rsq(floata);
+    colora = colora * colorb;
+    if(floata > 0.5) {
+        colorb = colorb + colora;
+        floatb = floata * 2.0;
+    } else {
+        colora = colorb;
+    }
+    gl_FragColor = colorb;
+    gl_FragDepth = floatb > 0.0;
+    gl_FragColor = colora;
+}
@@ -0,0 +1,18 @@
+{
+    vec4 color = gl_Color;
+    vec4 albedo;
+    float roughness = 0.5;
+    if(gl_TexCoord[0] > 0.5) {
+        albedo = gl_Color;
+        roughness = gl_TexCoord[1];
+    } else {
+        albedo = env1;
+        roughness = gl_TexCoord[2];
+        if(gl_TexCoord[3] > 0.25) {
+            color = env2;
+        } else {
+            color = env3;
+        }
+    }
+    gl_FragColor = color * albedo * roughness;
+}
@@ -0,0 +1,28 @@
+{
+    vec4 base = gl_Color;
+    vec4 detail = env3;
+    float blend = gl_TexCoord[0];
+    float bias = gl_TexCoord[1];
+    vec4 color;
+
+    /* MAD */
+    float scaled = blend * 0.5 + bias;
+    float offset = bias - blend * scaled;
+
+    /* LRP */
+    color = base + scaled * (detail - base);
+
+    /* conditions compare the sign of the difference */
+    if(offset < bias) {
+        color = color * detail;
+    }
+    if(blend >= 0.25) {
+        color = -color;
+    } else {
+        color = env1;
+    }
+    if(base == detail) {
+        color = env2;
+    }
+    gl_FragColor = color;
+}
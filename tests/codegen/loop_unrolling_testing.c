@@ -0,0 +1,15 @@
+{
+    vec4 color = gl_Color;
+    vec4 sum = vec4(0.0, 0.0, 0.0, 0.0);
+    int i = 0;
+    int steps = 0;
+    while(i < 3) {
+        sum = sum + env1;
+        i = i + 1;
+    }
+    while(steps < 2 && color[0] < 0.5) {
+        color = color * env2;
+        steps = steps + 1;
+    }
+    gl_FragColor = color + sum;
+}
@@ -0,0 +1,11 @@
+{
+    const float undefinedPow = -1.0 ^ 0.5;
+    vec4 color = gl_Color;
+    bool aboveNaN = color[0] > (-1.0 ^ 0.5);
+    float infinite = color[1] * (0.0 ^ -1.0);
+    color = color * vec4(0.25, 0.5, 0.75, 2.0) + vec4(3.0, 5.0, 7.0, 9.0);
+    if(aboveNaN) {
+        color[2] = infinite * undefinedPow;
+    }
+    gl_FragColor = color;
+}
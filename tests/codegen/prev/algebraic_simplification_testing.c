@@ -0,0 +1,21 @@
+Info: Optimization for declaration of const-qualified symbol 'one' of type 'const float' successful at Line 2:5 to Line 2:27.
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : __$temp_0, $color_0
+TEMP   __$reg_0                ;
+
+
+# Auto-Generated Immediate Value Registers
+
+
+# Instructions
+
+SGE    __$reg_0.x              ,  fragment.texcoord       ,  fragment.texcoord.y     ;
+
+CMP    __$reg_0                ,  -__$reg_0.x             ,  fragment.color          ,  fragment.color.secondary;
+
+MUL    result.color            ,  __$reg_0                ,  fragment.texcoord.x     ;
+
+
+END
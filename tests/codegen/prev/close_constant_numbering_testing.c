@@ -0,0 +1,22 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $a_0
+TEMP   __$reg_0                ;
+# __$reg_1 : __$temp_0
+TEMP   __$reg_1                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_0              =  {1.0000001,1.0000002}               ;
+
+
+# Instructions
+
+MUL    __$reg_0                ,  fragment.color          ,  __$param_0.x            ;
+
+MAD    __$reg_1                ,  -fragment.color         ,  __$param_0.y            ,  __$reg_0                ;
+ADD    result.color            ,  __$reg_1                ,  __$reg_0                ;
+
+
+END
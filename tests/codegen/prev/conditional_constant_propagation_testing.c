@@ -0,0 +1,30 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $color_0
+TEMP   __$reg_0                ;
+# __$reg_1 : __$temp_0
+TEMP   __$reg_1                ;
+# __$reg_2 : __$temp_1
+TEMP   __$reg_2                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_true           =  {1.0,1.0,1.0,1.0}                   ;
+PARAM  __$param_0              =  {2.0,0.5}                           ;
+
+
+# Instructions
+
+MUL    __$reg_0                ,  fragment.color          ,  __$param_0.x            ;
+
+MOV    __$reg_0.w              ,  __$param_true.x         ;
+
+# Evaluate if statement condition
+SGE    __$reg_1.x              ,  __$param_0.y            ,  __$reg_0                ;
+
+ADD    __$reg_2                ,  __$reg_0                ,  fragment.texcoord       ;
+CMP    result.color            ,  -__$reg_1.x             ,  __$reg_0                ,  __$reg_2                ;
+
+
+END
@@ -0,0 +1,33 @@
+Info: Optimization for declaration of const-qualified symbol 'degree' of type 'const float' successful at Line 2:5 to Line 2:48.
+Info: Optimization for declaration of const-qualified symbol 'offset' of type 'const vec4' successful at Line 3:5 to Line 3:50.
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $angle_0
+TEMP   __$reg_0                ;
+# __$reg_1 : __$temp_0, $color_0
+TEMP   __$reg_1                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_0              =  {0.03490656,6.0,-0.03490656,2.0}    ;
+PARAM  __$param_1              =  {0.5,1.5,2.5,3.5}                   ;
+
+
+# Instructions
+
+MUL    __$reg_0.x              ,  fragment.texcoord       ,  __$param_0              ;
+
+MUL    __$reg_1                ,  fragment.color          ,  __$param_1              ;
+MUL    __$reg_1                ,  __$reg_1                ,  __$param_0.y            ;
+
+MUL    __$reg_0.x              ,  __$reg_0                ,  __$param_0.z            ;
+MOV    __$reg_1.x              ,  __$reg_0                ;
+
+MUL    __$reg_0.x              ,  __$reg_1.y              ,  __$param_0.w            ;
+MOV    __$reg_1.y              ,  __$reg_0.x              ;
+
+MOV    result.color            ,  __$reg_1                ;
+
+
+END
@@ -0,0 +1,41 @@
+Info: Optimization for declaration of const-qualified symbol 'scale' of type 'const float' successful at Line 2:5 to Line 2:29.
+Info: Optimization for declaration of const-qualified symbol 'weights' of type 'const vec3' successful at Line 3:5 to Line 3:48.
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $luma_0
+TEMP   __$reg_0                ;
+# __$reg_1 : __$temp_0, $color_0$1
+TEMP   __$reg_1                ;
+# __$reg_2 : $color_0, __$temp_1
+TEMP   __$reg_2                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_true           =  {1.0,1.0,1.0,1.0}                   ;
+PARAM  __$param_false          =  {-1.0,-1.0,-1.0,-1.0}               ;
+PARAM  __$param_0              =  {0.25,0.5,0.75,1.0}                 ;
+PARAM  __$param_1              =  {0.25,0.75,2.0,0.0}                 ;
+
+
+# Instructions
+
+DP3    __$reg_0.x              ,  fragment.color          ,  __$param_0              ;
+
+# Evaluate if statement condition
+SUB    __$reg_0.y              ,  __$param_0              ,  __$reg_0.x              ;
+CMP    __$reg_0.y              ,  __$reg_0                ,  __$param_true.x         ,  __$param_false.x        ;
+
+MUL    __$reg_1                ,  fragment.color          ,  __$param_0.yyyw         ;
+CMP    __$reg_2                ,  __$reg_0.y              ,  fragment.color          ,  __$reg_1                ;
+
+ADD    __$reg_2                ,  __$reg_2                ,  __$param_1              ;
+CMP    __$reg_1                ,  __$reg_0.y              ,  __$reg_2                ,  __$reg_1                ;
+
+MAD    __$reg_0.x              ,  __$reg_0                ,  __$param_1.z            ,  __$param_true           ;
+MOV    __$reg_1.w              ,  __$reg_0.x              ;
+
+MOV    result.color            ,  __$reg_1                ;
+
+
+END
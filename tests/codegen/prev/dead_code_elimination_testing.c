@@ -0,0 +1,47 @@
+Info: Optimization for declaration of const-qualified symbol 'colorUnused' of type 'const vec4' successful at Line 2:5 to Line 2:55.
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $floata_0
+TEMP   __$reg_0                ;
+# __$reg_1 : $colora_0
+TEMP   __$reg_1                ;
+# __$reg_2 : __$temp_0, $colorb_0
+TEMP   __$reg_2                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_true           =  {1.0,1.0,1.0,1.0}                   ;
+PARAM  __$param_false          =  {-1.0,-1.0,-1.0,-1.0}               ;
+PARAM  __$param_zero           =  {0.0,0.0,0.0,0.0}                   ;
+PARAM  __$param_0              =  {0.5,2.0}                           ;
+
+
+# Instructions
+
+DP3    __$reg_0.x              ,  fragment.color          ,  fragment.texcoord       ;
+
+RSQ    __$reg_0.y              ,  __$reg_0.x              ;
+
+MUL    __$reg_1                ,  fragment.color          ,  fragment.texcoord       ;
+
+# Evaluate if statement condition
+SUB    __$reg_0.z              ,  __$param_0.x            ,  __$reg_0.x              ;
+CMP    __$reg_0.z              ,  __$reg_0                ,  __$param_true.x         ,  __$param_false.x        ;
+
+ADD    __$reg_2                ,  fragment.texcoord       ,  __$reg_1                ;
+CMP    __$reg_2                ,  __$reg_0.z              ,  fragment.texcoord       ,  __$reg_2                ;
+
+MUL    __$reg_0.x              ,  __$reg_0                ,  __$param_0.y            ;
+CMP    __$reg_0.y              ,  __$reg_0.z              ,  __$reg_0                ,  __$reg_0.x              ;
+
+CMP    result.color            ,  -__$reg_0.z             ,  __$reg_1                ,  __$reg_2                ;
+
+SUB    __$reg_0.x              ,  __$param_zero           ,  __$reg_0.y              ;
+CMP    __$reg_0.x              ,  __$reg_0                ,  __$param_true           ,  __$param_false          ;
+
+# Write result registers
+MOV    result.depth            ,  __$reg_0.x              ;
+
+
+END
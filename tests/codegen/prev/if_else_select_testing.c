@@ -0,0 +1,32 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : __$temp_0
+TEMP   __$reg_0                ;
+# __$reg_1 : $albedo_0, __$temp_2
+TEMP   __$reg_1                ;
+# __$reg_2 : __$temp_1, $color_0
+TEMP   __$reg_2                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_0              =  {0.5,0.25}                          ;
+
+
+# Instructions
+
+# Evaluate if statement condition
+SUB    __$reg_0.xy             ,  __$param_0              ,  fragment.texcoord.xwww  ;
+
+CMP    __$reg_1                ,  __$reg_0.x              ,  fragment.color          ,  program.env[1]          ;
+
+CMP    __$reg_0.z              ,  __$reg_0.x              ,  fragment.texcoord.y     ,  fragment.texcoord       ;
+
+CMP    __$reg_2                ,  __$reg_0.y              ,  program.env[2]          ,  program.env[3]          ;
+CMP    __$reg_2                ,  __$reg_0.x              ,  fragment.color          ,  __$reg_2                ;
+
+MUL    __$reg_1                ,  __$reg_2                ,  __$reg_1                ;
+MUL    result.color            ,  __$reg_1                ,  __$reg_0.z              ;
+
+
+END
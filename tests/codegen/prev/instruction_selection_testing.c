@@ -0,0 +1,44 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $scaled_0
+TEMP   __$reg_0                ;
+# __$reg_1 : $color_0, $color_0$1
+TEMP   __$reg_1                ;
+# __$reg_2 : __$temp_0, __$temp_1, __$temp_2
+TEMP   __$reg_2                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_true           =  {1.0,1.0,1.0,1.0}                   ;
+PARAM  __$param_0              =  {0.5,0.25}                          ;
+
+
+# Instructions
+
+MAD    __$reg_0.x              ,  fragment.texcoord       ,  __$param_0              ,  fragment.texcoord.y     ;
+
+MAD    __$reg_0.y              ,  -fragment.texcoord.x    ,  __$reg_0.x              ,  fragment.texcoord       ;
+
+LRP    __$reg_1                ,  __$reg_0.x              ,  program.env[3]          ,  fragment.color          ;
+
+# Evaluate if statement condition
+SGE    __$reg_0.x              ,  __$reg_0.y              ,  fragment.texcoord.y     ;
+
+MUL    __$reg_2                ,  __$reg_1                ,  program.env[3]          ;
+CMP    __$reg_1                ,  -__$reg_0.x             ,  __$reg_1                ,  __$reg_2                ;
+
+# Evaluate if statement condition
+SUB    __$reg_0.x              ,  fragment.texcoord       ,  __$param_0.y            ;
+
+CMP    __$reg_1                ,  __$reg_0.x              ,  program.env[1]          ,  -__$reg_1               ;
+
+# Evaluate if statement condition
+SUB    __$reg_2                ,  fragment.color          ,  program.env[3]          ;
+ABS    __$reg_2                ,  __$reg_2                ;
+DP4    __$reg_0.x              ,  __$reg_2                ,  __$param_true           ;
+
+CMP    result.color            ,  -__$reg_0.x             ,  __$reg_1                ,  program.env[2]          ;
+
+
+END
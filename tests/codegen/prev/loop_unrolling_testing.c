@@ -0,0 +1,50 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $sum_0, __$temp_1, $color_0
+TEMP   __$reg_0                ;
+# __$reg_1 : $sum_0$1
+TEMP   __$reg_1                ;
+# __$reg_2 : __$temp_0, $color_0
+TEMP   __$reg_2                ;
+# __$reg_3 : $steps_0, __$temp_2
+TEMP   __$reg_3                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_true           =  {1.0,1.0,1.0,1.0}                   ;
+PARAM  __$param_false          =  {-1.0,-1.0,-1.0,-1.0}               ;
+PARAM  __$param_zero           =  {0.0,0.0,0.0,0.0}                   ;
+PARAM  __$param_0              =  {0.5,2.0}                           ;
+
+
+# Instructions
+
+ADD    __$reg_0                ,  program.env[1]          ,  program.env[1]          ;
+
+ADD    __$reg_1                ,  __$reg_0                ,  program.env[1]          ;
+
+# Evaluate while statement condition, iteration 0
+SUB    __$reg_0.x              ,  fragment.color          ,  __$param_0              ;
+CMP    __$reg_0.x              ,  __$reg_0                ,  __$param_true           ,  __$param_false          ;
+
+MUL    __$reg_2                ,  fragment.color          ,  program.env[2]          ;
+CMP    __$reg_2                ,  __$reg_0.x              ,  fragment.color          ,  __$reg_2                ;
+
+CMP    __$reg_3.x              ,  __$reg_0                ,  __$param_zero           ,  __$param_true           ;
+
+# Evaluate while statement condition, iteration 1
+SUB    __$reg_0.y              ,  __$reg_3.x              ,  __$param_0              ;
+CMP    __$reg_0.y              ,  __$reg_0                ,  __$param_true.x         ,  __$param_false.x        ;
+SUB    __$reg_0.z              ,  __$reg_2.x              ,  __$param_0.x            ;
+CMP    __$reg_0.z              ,  __$reg_0                ,  __$param_true.x         ,  __$param_false.x        ;
+MIN    __$reg_0.y              ,  __$reg_0                ,  __$reg_0.z              ;
+CMP    __$reg_0                ,  __$reg_0.x              ,  __$reg_0.x              ,  __$reg_0.y              ;
+
+MUL    __$reg_3                ,  __$reg_2                ,  program.env[2]          ;
+CMP    __$reg_0                ,  __$reg_0                ,  __$reg_2                ,  __$reg_3                ;
+
+ADD    result.color            ,  __$reg_0                ,  __$reg_1                ;
+
+
+END
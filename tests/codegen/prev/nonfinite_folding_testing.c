@@ -0,0 +1,33 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : __$temp_0
+TEMP   __$reg_0                ;
+# __$reg_1 : $color_0
+TEMP   __$reg_1                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_false          =  {-1.0,-1.0,-1.0,-1.0}               ;
+PARAM  __$param_zero           =  {0.0,0.0,0.0,0.0}                   ;
+PARAM  __$param_0              =  {0.25,0.5,0.75,2.0}                 ;
+PARAM  __$param_1              =  {3.0,5.0,7.0,9.0}                   ;
+
+
+# Instructions
+
+RSQ    __$reg_0.x              ,  __$param_false.x        ;
+RCP    __$reg_0.x              ,  __$reg_0.x              ;
+SGE    __$reg_0.y              ,  __$reg_0.x              ,  fragment.color.x        ;
+
+RCP    __$reg_0.z              ,  __$param_zero.x         ;
+MUL    __$reg_0.z              ,  fragment.color.y        ,  __$reg_0                ;
+
+MAD    __$reg_1                ,  fragment.color          ,  __$param_0              ,  __$param_1              ;
+
+MUL    __$reg_0.x              ,  __$reg_0.z              ,  __$reg_0                ;
+MOV    result.color            ,  __$reg_1                ;
+CMP    result.color.z          ,  -__$reg_0.y             ,  __$reg_1                ,  __$reg_0.x              ;
+
+
+END
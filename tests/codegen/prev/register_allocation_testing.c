@@ -0,0 +1,29 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $floata_0
+TEMP   __$reg_0                ;
+# __$reg_1 : $colorc_0
+TEMP   __$reg_1                ;
+# __$reg_2 : __$temp_0
+TEMP   __$reg_2                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_0              =  0.5                                 ;
+
+
+# Instructions
+
+DP3    __$reg_0.x              ,  fragment.color          ,  fragment.texcoord       ;
+
+MAD    __$reg_1                ,  fragment.color          ,  __$reg_0.x              ,  fragment.texcoord       ;
+
+# Evaluate if statement condition
+SGE    __$reg_0.x              ,  __$param_0              ,  __$reg_0                ;
+
+MUL    __$reg_2                ,  __$reg_1                ,  fragment.texcoord       ;
+CMP    result.color            ,  -__$reg_0.x             ,  __$reg_1                ,  __$reg_2                ;
+
+
+END
@@ -0,0 +1,37 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $color_0
+TEMP   __$reg_0                ;
+# __$reg_1 : $base_0
+TEMP   __$reg_1                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_zero           =  {0.0,0.0,0.0,0.0}                   ;
+PARAM  __$param_0              =  {0.25,3.5,0.75,2.5}                 ;
+PARAM  __$param_1              =  1.3333334                           ;
+
+
+# Instructions
+
+MUL    __$reg_0                ,  fragment.color          ,  __$param_0              ;
+
+POW    __$reg_0.x              ,  fragment.color.x        ,  __$param_0.y            ;
+
+POW    __$reg_1.x              ,  __$param_0.w            ,  fragment.color.y        ;
+
+RCP    __$reg_1.y              ,  fragment.color.z        ;
+
+ADD    __$reg_0.x              ,  __$reg_0                ,  __$reg_1                ;
+ADD    __$reg_0.x              ,  __$reg_0                ,  __$reg_1.y              ;
+
+RCP    __$reg_0.z              ,  __$param_zero.x         ;
+MUL    __$reg_0.z              ,  fragment.color.w        ,  __$reg_0                ;
+
+MUL    __$reg_0.w              ,  __$reg_1.y              ,  __$param_1.x            ;
+
+MOV    result.color            ,  __$reg_0                ;
+
+
+END
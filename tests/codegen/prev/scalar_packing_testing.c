@@ -0,0 +1,33 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $lengthSquared_0
+TEMP   __$reg_0                ;
+# __$reg_1 : __$temp_0
+TEMP   __$reg_1                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_0              =  0.5                                 ;
+
+
+# Instructions
+
+DP3    __$reg_0.x              ,  fragment.texcoord       ,  fragment.texcoord       ;
+
+RSQ    __$reg_0.y              ,  __$reg_0.x              ;
+
+DP3    __$reg_0.z              ,  fragment.texcoord       ,  program.env[1]          ;
+MUL    __$reg_0.y              ,  __$reg_0.z              ,  __$reg_0                ;
+
+MUL    __$reg_0.zw             ,  fragment.color.xxxy     ,  __$reg_0.y              ;
+
+MAD    __$reg_0.y              ,  program.env[2].x        ,  __$param_0.x            ,  __$reg_0                ;
+
+MOV    __$reg_1                ,  __$reg_0.zwww           ;
+MOV    __$reg_1.z              ,  __$reg_0.y              ;
+MOV    __$reg_1.w              ,  __$reg_0.x              ;
+MOV    result.color            ,  __$reg_1                ;
+
+
+END
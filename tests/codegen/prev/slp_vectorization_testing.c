@@ -0,0 +1,24 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : __$temp_0
+TEMP   __$reg_0                ;
+# __$reg_1 : __$temp_1
+TEMP   __$reg_1                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_0              =  {0.25,0.5}                          ;
+
+
+# Instructions
+
+MUL    __$reg_0.xyz            ,  fragment.color          ,  program.env[1].x        ;
+
+ADD    __$reg_1.xy             ,  fragment.texcoord.wzzz  ,  __$param_0              ;
+
+MUL    __$reg_0.w              ,  __$reg_1.x              ,  __$reg_1.y              ;
+MOV    result.color            ,  __$reg_0                ;
+
+
+END
@@ -0,0 +1,39 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $scaled_0, __$temp_1
+TEMP   __$reg_0                ;
+# __$reg_1 : $inverse_0
+TEMP   __$reg_1                ;
+# __$reg_2 : __$temp_0
+TEMP   __$reg_2                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_0              =  0.25                                ;
+
+
+# Instructions
+
+MUL    __$reg_0.x              ,  fragment.texcoord.z     ,  __$param_0              ;
+
+MUL    __$reg_0.y              ,  fragment.texcoord.x     ,  fragment.texcoord.x     ;
+
+MUL    __$reg_0.z              ,  __$reg_0.y              ,  fragment.texcoord.x     ;
+
+RSQ    __$reg_0.w              ,  fragment.texcoord.x     ;
+RCP    __$reg_0.w              ,  __$reg_0.w              ;
+
+RCP    __$reg_1.x              ,  fragment.texcoord.x     ;
+
+POW    __$reg_1.y              ,  fragment.texcoord.x     ,  fragment.texcoord.y     ;
+
+MOV    __$reg_2                ,  __$reg_0.y              ;
+MOV    __$reg_2.y              ,  __$reg_0.z              ;
+MOV    __$reg_2.z              ,  __$reg_0.w              ;
+MOV    __$reg_2.w              ,  __$reg_1.x              ;
+MUL    __$reg_0                ,  __$reg_2                ,  __$reg_0.x              ;
+MUL    result.color            ,  __$reg_0                ,  __$reg_1.y              ;
+
+
+END
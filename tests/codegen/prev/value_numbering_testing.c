@@ -0,0 +1,42 @@
+!!ARBfp1.0
+
+# Allocated Temporary Registers
+# __$reg_0 : $diffuse_0
+TEMP   __$reg_0                ;
+# __$reg_1 : __$temp_0, $color_0, __$temp_2, $color_0$1
+TEMP   __$reg_1                ;
+# __$reg_2 : __$temp_1
+TEMP   __$reg_2                ;
+
+
+# Auto-Generated Immediate Value Registers
+PARAM  __$param_true           =  {1.0,1.0,1.0,1.0}                   ;
+PARAM  __$param_false          =  {-1.0,-1.0,-1.0,-1.0}               ;
+PARAM  __$param_zero           =  {0.0,0.0,0.0,0.0}                   ;
+
+
+# Instructions
+
+DP3    __$reg_0.x              ,  fragment.texcoord       ,  program.env[1]          ;
+
+DP3    __$reg_0.y              ,  fragment.texcoord       ,  fragment.texcoord       ;
+RSQ    __$reg_0.y              ,  __$reg_0.y              ;
+
+# Evaluate if statement condition
+SUB    __$reg_0.z              ,  __$param_zero.x         ,  __$reg_0.x              ;
+CMP    __$reg_0.z              ,  __$reg_0                ,  __$param_true.x         ,  __$param_false.x        ;
+
+MUL    __$reg_1                ,  fragment.color          ,  __$reg_0.x              ;
+CMP    __$reg_1                ,  __$reg_0.z              ,  fragment.color          ,  __$reg_1                ;
+
+MUL    __$reg_2                ,  __$reg_1                ,  __$reg_0.y              ;
+CMP    __$reg_1                ,  __$reg_0.z              ,  __$reg_1                ,  __$reg_2                ;
+
+MUL    __$reg_0.y              ,  __$reg_0                ,  __$reg_0.x              ;
+MUL    __$reg_1                ,  __$reg_1                ,  __$reg_0.y              ;
+CMP    __$reg_1                ,  __$reg_0.z              ,  __$reg_1                ,  __$reg_2                ;
+
+MUL    result.color            ,  __$reg_1                ,  __$reg_0.x              ;
+
+
+END
@@ -0,0 +1,10 @@
+{
+    vec4 colora = gl_Color;
+    vec4 colorb = gl_TexCoord;
+    float floata = dp3(colora, colorb);
+    vec4 colorc = colora * floata + colorb;
+    if(floata > 0.5) {
+        colorc = colorc * colorb;
+    }
+    gl_FragColor = colorc;
+}
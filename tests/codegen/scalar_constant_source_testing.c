@@ -0,0 +1,10 @@
+{
+    vec4 color = gl_Color * vec4(0.25, 3.5, 0.75, 2.5);
+    float power = gl_Color[0] ^ 3.5;
+    float base = 2.5 ^ gl_Color[1];
+    float inverse = 1.0 / gl_Color[2];
+    color[0] = power + base + inverse;
+    color[2] = gl_Color[3] * (1.0 / 0.0);
+    color[3] = inverse * (1.0 / 0.75);
+    gl_FragColor = color;
+}
@@ -0,0 +1,11 @@
+{
+    vec4 normal = gl_TexCoord;
+    vec4 light = env1;
+    float lengthSquared = dp3(normal, normal);
+    float invLength = rsq(lengthSquared);
+    float diffuse = dp3(normal, light) * invLength;
+    float ambient = env2[0] * 0.5;
+    vec2 uv = vec2(gl_Color[0], gl_Color[1]) * diffuse;
+    float shade = diffuse + ambient;
+    gl_FragColor = vec4(uv[0], uv[1], shade, lengthSquared);
+}
@@ -0,0 +1,10 @@
+{
+    vec4 albedo = gl_Color;
+    float intensity = env1[0];
+    float red = albedo[0] * intensity;
+    float green = albedo[1] * intensity;
+    float blue = albedo[2] * intensity;
+    float alpha = gl_TexCoord[3] + 0.25;
+    float fog = gl_TexCoord[2] + 0.5;
+    gl_FragColor = vec4(red, green, blue, alpha * fog);
+}
@@ -0,0 +1,10 @@
+{
+    float x = gl_TexCoord[0];
+    float scaled = gl_TexCoord[2] / 4.0;
+    float square = x ^ 2.0;
+    float cube = x ^ 3.0;
+    float root = x ^ 0.5;
+    float inverse = x ^ -1.0;
+    float general = x ^ gl_TexCoord[1];
+    gl_FragColor = vec4(square, cube, root, inverse) * scaled * general;
+}
@@ -0,0 +1,16 @@
+{
+    vec4 normal = gl_TexCoord;
+    vec4 light = env1;
+    vec4 color = gl_Color;
+    float diffuse = dp3(normal, light);
+    float invLength = rsq(dp3(normal, normal));
+    if(dp3(normal, light) > 0.0) {
+        color = color * dp3(light, normal);
+    }
+    if(dp3(normal, light) > 0.0) {
+        color = color * rsq(dp3(normal, normal));
+    } else {
+        color = color * (invLength * diffuse);
+    }
+    gl_FragColor = color * diffuse;
+}
@@ -20,3 +20,14 @@ statement -> while ( expression ) statement
 statements -> statements statement
 scope -> { declarations statements }
 program -> scope
+Failed to compile
+
+--------------------------------------------------------------------------
+Error-0: Missing declaration for symbol 'a' at Line 3:12 to Line 3:13.
+      3:              while(-a[20] == 20) {
+                             ^             
+--------------------------------------------------------------------------
+Error-1: While-statement condition expression has unknown type at Line 3:11 to Line 3:23. Expecting type 'bool'.
+      3:              while(-a[20] == 20) {
+                            ^^^^^^^^^^^^   
+--------------------------------------------------------------------------